@@ -0,0 +1,165 @@
+//-----------------------------------------------
+/**
+* This is the implementation file for the block tridiagonal
+* solvers, the block Thomas algorithm and parallel cyclic
+* reduction.
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+
+#include <atomic>
+#include <stdexcept>
+#include <utility>
+#include "BlockTridiagonal.h"
+#include "Parallel.h"
+
+using namespace std;
+
+namespace {
+  // returns mat * v
+  Vec2 apply(const Mat2x2 &mat, const Vec2 &v){
+    double m[4];
+    mat.getElements(m);
+    Vec2 result = {(m[0] * v.x) + (m[1] * v.y), (m[2] * v.x) + (m[3] * v.y)};
+    return result;
+  }
+
+  Vec2 subtract(const Vec2 &lhs, const Vec2 &rhs){
+    Vec2 result = {lhs.x - rhs.x, lhs.y - rhs.y};
+    return result;
+  }
+
+  void checkSizes(const vector<Mat2x2> &lower, const vector<Mat2x2> &diag,
+                  const vector<Mat2x2> &upper, const vector<Vec2> &rhs){
+    if(lower.size() != diag.size() || upper.size() != diag.size() || rhs.size() != diag.size()){
+      throw invalid_argument("invalid argument");
+    }
+  }
+}
+
+//-----------------------------------------------
+/*
+* This function solves the system with the block Thomas
+* algorithm. The forward sweep eliminates the lower blocks
+*
+* C'i = (Bi - Ai * C'i-1)^-1 * Ci
+* d'i = (Bi - Ai * C'i-1)^-1 * (di - Ai * d'i-1)
+*
+* and the backward sweep finds xi = d'i - C'i * xi+1
+*/
+//-----------------------------------------------
+vector<Vec2> solveBlockTridiagonal(const vector<Mat2x2> &lower, const vector<Mat2x2> &diag,
+                                   const vector<Mat2x2> &upper, const vector<Vec2> &rhs){
+  checkSizes(lower, diag, upper, rhs);
+  size_t n = diag.size();
+  if(n == 0){
+    return vector<Vec2>();
+  }
+  vector<Mat2x2> upperPrime(n);
+  vector<Vec2> x(n);
+  Mat2x2 pivotInverse;
+  for(size_t i = 0; i < n; i++){
+    Mat2x2 pivot = diag[i];
+    Vec2 d = rhs[i];
+    if(i > 0){
+      pivot -= lower[i] * upperPrime[i - 1];
+      d = subtract(d, apply(lower[i], x[i - 1]));
+    }
+    if(!pivot.tryInverse(pivotInverse)){
+      throw overflow_error("Singular pivot");
+    }
+    upperPrime[i] = pivotInverse * upper[i];
+    x[i] = apply(pivotInverse, d);
+  }
+  for(size_t i = n - 1; i-- > 0;){
+    x[i] = subtract(x[i], apply(upperPrime[i], x[i + 1]));
+  }
+  return x;
+}
+
+//-----------------------------------------------
+/*
+* This function solves the system with parallel cyclic
+* reduction. In the step with stride s every row i removes
+* its coupling to the rows i - s and i + s
+*
+* alpha = -Ai * Bi-s^-1,  gamma = -Ci * Bi+s^-1
+* Ai = alpha * Ai-s,      Ci = gamma * Ci+s
+* Bi = Bi + alpha * Ci-s + gamma * Ai+s
+* di = di + alpha * di-s + gamma * di+s
+*
+* and after the stride reaches n every row is decoupled,
+* so xi = Bi^-1 * di.
+*/
+//-----------------------------------------------
+vector<Vec2> solveBlockTridiagonalPcr(const vector<Mat2x2> &lower, const vector<Mat2x2> &diag,
+                                      const vector<Mat2x2> &upper, const vector<Vec2> &rhs){
+  return solveBlockTridiagonalPcr(ThreadPool::instance(), lower, diag, upper, rhs);
+}
+
+vector<Vec2> solveBlockTridiagonalPcr(ThreadPool &pool, const vector<Mat2x2> &lower, const vector<Mat2x2> &diag,
+                                      const vector<Mat2x2> &upper, const vector<Vec2> &rhs){
+  checkSizes(lower, diag, upper, rhs);
+  size_t n = diag.size();
+  vector<Mat2x2> a(lower), b(diag), c(upper), nextA(n), nextB(n), nextC(n), inverses(n);
+  vector<Vec2> d(rhs), nextD(n);
+  if(n > 0){
+    a[0] = Mat2x2();
+    c[n - 1] = Mat2x2();
+  }
+  atomic<bool> singular(false);
+  for(size_t s = 1; s < n; s *= 2){
+    parallelFor(pool, 0, n, 0, [&](size_t i){
+      if(!b[i].tryInverse(inverses[i])){
+        singular = true;
+      }
+    });
+    if(singular){
+      throw overflow_error("Singular pivot");
+    }
+    parallelFor(pool, 0, n, 0, [&](size_t i){
+      Mat2x2 newB = b[i];
+      Vec2 newD = d[i];
+      Mat2x2 newA, newC;
+      if(i >= s){
+        Mat2x2 alpha = -1 * (a[i] * inverses[i - s]);
+        newA = alpha * a[i - s];
+        newB += alpha * c[i - s];
+        Vec2 term = apply(alpha, d[i - s]);
+        newD.x += term.x;
+        newD.y += term.y;
+      }
+      if(i + s < n){
+        Mat2x2 gamma = -1 * (c[i] * inverses[i + s]);
+        newC = gamma * c[i + s];
+        newB += gamma * a[i + s];
+        Vec2 term = apply(gamma, d[i + s]);
+        newD.x += term.x;
+        newD.y += term.y;
+      }
+      nextA[i] = newA;
+      nextB[i] = newB;
+      nextC[i] = newC;
+      nextD[i] = newD;
+    });
+    swap(a, nextA);
+    swap(b, nextB);
+    swap(c, nextC);
+    swap(d, nextD);
+  }
+  vector<Vec2> x(n);
+  parallelFor(pool, 0, n, 0, [&](size_t i){
+    if(!b[i].tryInverse(inverses[i])){
+      singular = true;
+      return;
+    }
+    x[i] = apply(inverses[i], d[i]);
+  });
+  if(singular){
+    throw overflow_error("Singular pivot");
+  }
+  return x;
+}
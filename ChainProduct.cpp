@@ -0,0 +1,305 @@
+//-----------------------------------------------
+/**
+* This is the implementation file for ChainProduct and
+* ChainProductBatch classes.
+*
+* The power of two is read from the exponent bits of the
+* largest element instead of frexp, and the scale factor is
+* built from bits instead of ldexp, so the renormalization is
+* a few integer operations which vectorize. A subnormal
+* element is read after a multiplication by 2^54, which makes
+* it normal. The exponent is in [-1074, 1024], so 2^-e isn't
+* always a normal double, the elements are multiplied by two
+* halves of it instead, which are, and a zero matrix isn't
+* scaled.
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include "ChainProduct.h"
+#include "Parallel.h"
+
+using namespace std;
+
+namespace {
+  const size_t chainsPerTask = 4096;
+  const size_t blockSize = 64;
+  const double ln2 = 0.693147180559945309417;
+  const double twoTo54 = 18014398509481984.0;
+  const double rangeLimit = 3.273390607896141870e150; // 2^500, see ChainProduct.h
+
+  // returns e such that |x| * 2^-e is in [0.5, 1), or 0 for zero
+  inline int64_t exponentOf(double x){
+    double scaled = x * twoTo54;
+    uint64_t bits, scaledBits;
+    memcpy(&bits, &x, sizeof(bits));
+    memcpy(&scaledBits, &scaled, sizeof(scaledBits));
+    int64_t biased = (int64_t) ((bits >> 52) & 0x7ff);
+    int64_t scaledBiased = (int64_t) ((scaledBits >> 52) & 0x7ff);
+    int64_t e = biased == 0 ? scaledBiased - 1022 - 54 : biased - 1022;
+    e = e > 1024 ? 1024 : e;
+    return scaledBiased == 0 ? 0 : e;
+  }
+
+  // returns 2^-e for e in [-1023, 1022]
+  inline double inversePowerOfTwo(int64_t e){
+    uint64_t bits = (uint64_t) (1023 - e) << 52;
+    double x;
+    memcpy(&x, &bits, sizeof(x));
+    return x;
+  }
+
+  inline double maxAbs(double a, double b, double c, double d){
+    double x = fabs(a) > fabs(b) ? fabs(a) : fabs(b);
+    double y = fabs(c) > fabs(d) ? fabs(c) : fabs(d);
+    return x > y ? x : y;
+  }
+
+  // returns 2^-e as high * low for e in [-1074, 1024], both halves are normal
+  inline void inversePowerOfTwo(int64_t e, double &high, double &low){
+    high = inversePowerOfTwo(e >> 1);
+    low = inversePowerOfTwo(e - (e >> 1));
+  }
+
+  // 1 if the largest element has left [2^-500, 2^500], a zero matrix counts as inside
+  inline int outOfRange(double largest){
+    return (largest > rangeLimit) | ((largest < 1 / rangeLimit) & (largest != 0));
+  }
+
+  // the elements are scaled into [0.5, 1) first, so the squares can't overflow or underflow
+  inline double logNormOf(double a, double b, double c, double d, int64_t e){
+    int64_t shift = exponentOf(maxAbs(a, b, c, d));
+    double high, low;
+    inversePowerOfTwo(shift, high, low);
+    a = (a * high) * low;
+    b = (b * high) * low;
+    c = (c * high) * low;
+    d = (d * high) * low;
+    return (0.5 * log((a * a) + (b * b) + (c * c) + (d * d))) + ((double) (e + shift) * ln2);
+  }
+
+  // divides the matrix by 2^e, with e = exponentOf(largest element) it is exact
+  inline void scaleDown(double &a, double &b, double &c, double &d, int64_t e){
+    double high, low;
+    inversePowerOfTwo(e, high, low);
+    a = (a * high) * low;
+    b = (b * high) * low;
+    c = (c * high) * low;
+    d = (d * high) * low;
+  }
+
+  //-----------------------------------------------
+  /*
+  * This is a helper method which multiplies count chains by
+  * their next matrix, and renormalizes them if asked to or
+  * if the largest element of one of them has left the range.
+  * The state is copied through local arrays so the compiler
+  * can tell they don't overlap mats and vectorizes the loops.
+  */
+  //-----------------------------------------------
+  void multiplyBlock(const Mat2x2BatchView<const double> &mats, const Mat2x2BatchView<double> &state, int64_t *scale,
+                     size_t first, size_t count, bool renormalize){
+    double ma[blockSize], mb[blockSize], mc[blockSize], md[blockSize];
+    double pa[blockSize], pb[blockSize], pc[blockSize], pd[blockSize];
+    int64_t e[blockSize];
+    size_t bytes = count * sizeof(double);
+    memcpy(ma, mats.a + first, bytes);
+    memcpy(mb, mats.b + first, bytes);
+    memcpy(mc, mats.c + first, bytes);
+    memcpy(md, mats.d + first, bytes);
+    memcpy(pa, state.a + first, bytes);
+    memcpy(pb, state.b + first, bytes);
+    memcpy(pc, state.c + first, bytes);
+    memcpy(pd, state.d + first, bytes);
+    int outside = 0;
+    for(size_t i = 0; i < count; i++){
+      double a = (ma[i] * pa[i]) + (mb[i] * pc[i]);
+      double b = (ma[i] * pb[i]) + (mb[i] * pd[i]);
+      double c = (mc[i] * pa[i]) + (md[i] * pc[i]);
+      double d = (mc[i] * pb[i]) + (md[i] * pd[i]);
+      pa[i] = a;
+      pb[i] = b;
+      pc[i] = c;
+      pd[i] = d;
+      outside |= outOfRange(maxAbs(a, b, c, d));
+    }
+    if(renormalize || outside){
+      memcpy(e, scale + first, count * sizeof(int64_t));
+      for(size_t i = 0; i < count; i++){
+        int64_t shift = exponentOf(maxAbs(pa[i], pb[i], pc[i], pd[i]));
+        scaleDown(pa[i], pb[i], pc[i], pd[i], shift);
+        e[i] += shift;
+      }
+      memcpy(scale + first, e, count * sizeof(int64_t));
+    }
+    memcpy(state.a + first, pa, bytes);
+    memcpy(state.b + first, pb, bytes);
+    memcpy(state.c + first, pc, bytes);
+    memcpy(state.d + first, pd, bytes);
+  }
+
+  // calls fn(first, count) on blocks of at most blockSize chains, split over the ThreadPool
+  template <typename Function>
+  void forEachBlock(size_t chains, Function fn){
+    size_t tasks = (chains + chainsPerTask - 1) / chainsPerTask;
+    parallelFor(ThreadPool::instance(), 0, tasks, 1, [&](size_t task){
+      size_t last = (task + 1) * chainsPerTask < chains ? (task + 1) * chainsPerTask : chains;
+      for(size_t first = task * chainsPerTask; first < last; first += blockSize){
+        fn(first, last - first < blockSize ? last - first : blockSize);
+      }
+    });
+  }
+}
+
+//-----------------------------------------------
+/*
+* Constructor for the accumulator, it takes the number of
+* multiplications between two renormalizations.
+*/
+//-----------------------------------------------
+ChainProduct::ChainProduct(size_t interval1) : state(1, 0, 0, 1), scale(0), count(0), interval(interval1) {
+  if(interval == 0){
+    throw invalid_argument("invalid argument");
+  }
+}
+
+void ChainProduct::multiply(const Mat2x2 &mat){
+  state = mat * state;
+  count++;
+  if(count % interval == 0 || outOfRange(maxAbs(state[0], state[1], state[2], state[3]))){
+    renormalize();
+  }
+}
+
+void ChainProduct::renormalize(){
+  double elements[4];
+  state.getElements(elements);
+  int64_t shift = exponentOf(maxAbs(elements[0], elements[1], elements[2], elements[3]));
+  scaleDown(elements[0], elements[1], elements[2], elements[3], shift);
+  state.setElements(elements);
+  scale += shift;
+}
+
+void ChainProduct::reset(){
+  state = Mat2x2(1, 0, 0, 1);
+  scale = 0;
+  count = 0;
+}
+
+Mat2x2 ChainProduct::normalized() const{
+  return state;
+}
+
+int64_t ChainProduct::exponent() const{
+  return scale;
+}
+
+uint64_t ChainProduct::steps() const{
+  return count;
+}
+
+double ChainProduct::logNorm() const{
+  return logNormOf(state[0], state[1], state[2], state[3], scale);
+}
+
+double ChainProduct::lyapunovExponent() const{
+  return count == 0 ? numeric_limits<double>::quiet_NaN() : logNorm() / (double) count;
+}
+
+//-----------------------------------------------
+/*
+* Constructor for the batch, every chain starts with the
+* identity.
+*/
+//-----------------------------------------------
+ChainProductBatch::ChainProductBatch(size_t chains, size_t interval1)
+    : state(vector<Mat2x2>(chains, Mat2x2(1, 0, 0, 1))), scale(chains), count(0), interval(interval1) {
+  if(interval == 0){
+    throw invalid_argument("invalid argument");
+  }
+}
+
+//-----------------------------------------------
+/*
+* This function multiplies every chain by its next matrix,
+* it throws invalid_argument error if mats doesn't have one
+* matrix per chain.
+*/
+//-----------------------------------------------
+void ChainProductBatch::multiply(const Mat2x2BatchView<const double> &mats){
+  if(mats.size != size()){
+    throw invalid_argument("invalid argument");
+  }
+  count++;
+  bool renormalize = count % interval == 0;
+  Mat2x2BatchView<double> view = state.view();
+  forEachBlock(size(), [&](size_t first, size_t blockCount){
+    multiplyBlock(mats, view, scale.data(), first, blockCount, renormalize);
+  });
+}
+
+void ChainProductBatch::renormalize(){
+  Mat2x2BatchView<double> view = state.view();
+  for(size_t i = 0; i < size(); i++){
+    int64_t shift = exponentOf(maxAbs(view.a[i], view.b[i], view.c[i], view.d[i]));
+    scaleDown(view.a[i], view.b[i], view.c[i], view.d[i], shift);
+    scale[i] += shift;
+  }
+}
+
+void ChainProductBatch::reset(){
+  state = Mat2x2Batch<double>(vector<Mat2x2>(size(), Mat2x2(1, 0, 0, 1)));
+  scale.assign(size(), 0);
+  count = 0;
+}
+
+size_t ChainProductBatch::size() const{
+  return scale.size();
+}
+
+uint64_t ChainProductBatch::steps() const{
+  return count;
+}
+
+//-----------------------------------------------
+/*
+* Following functions write the state of every chain to
+* the output, which must hold size() elements.
+*/
+//-----------------------------------------------
+void ChainProductBatch::normalized(const Mat2x2BatchView<double> &out) const{
+  if(out.size != size()){
+    throw invalid_argument("invalid argument");
+  }
+  Mat2x2BatchView<const double> view = state.view();
+  memcpy(out.a, view.a, size() * sizeof(double));
+  memcpy(out.b, view.b, size() * sizeof(double));
+  memcpy(out.c, view.c, size() * sizeof(double));
+  memcpy(out.d, view.d, size() * sizeof(double));
+}
+
+void ChainProductBatch::exponents(int64_t *out) const{
+  memcpy(out, scale.data(), size() * sizeof(int64_t));
+}
+
+void ChainProductBatch::logNorms(double *out) const{
+  Mat2x2BatchView<const double> view = state.view();
+  for(size_t i = 0; i < size(); i++){
+    out[i] = logNormOf(view.a[i], view.b[i], view.c[i], view.d[i], scale[i]);
+  }
+}
+
+void ChainProductBatch::lyapunovExponents(double *out) const{
+  logNorms(out);
+  double steps = count == 0 ? numeric_limits<double>::quiet_NaN() : (double) count;
+  for(size_t i = 0; i < size(); i++){
+    out[i] /= steps;
+  }
+}
@@ -0,0 +1,92 @@
+//-----------------------------------------------
+/**
+* This is the header file for ChainProduct and
+* ChainProductBatch classes, which accumulate the product of a
+* long chain of matrices
+*
+* P = m[n-1] * ... * m[1] * m[0]
+*
+* without overflow or underflow. The product is kept as a
+* normalized matrix and a separate power of two,
+* P = normalized * 2^exponent. Every interval multiplications,
+* and after any multiplication which leaves the largest
+* element outside [2^-500, 2^500], the normalized matrix is
+* divided by the power of two which brings its largest element
+* into [0.5, 1), which is exact, needs no zero check and moves
+* the scale into the exponent.
+*
+* logNorm() is the natural logarithm of the Frobenius norm of
+* P and lyapunovExponent() = logNorm() / n is the estimate of
+* the largest Lyapunov exponent of the chain. logNorm() scales
+* the elements before it squares them, so it is finite for
+* every non-zero normalized matrix.
+*
+* A multiplication starts from a largest element of at least
+* 2^-500, so matrices with elements down to about 1.e-150
+* can't underflow the product, e.g a chain of
+* Mat2x2(1.e-45, 0, 0, 1.e-45) keeps its exact scale. Smaller
+* elements, or cancellation down to zero, may lose elements or
+* the whole product to underflow, and a zero product has a
+* logNorm() of -inf. Elements up to about 1.e150 can't
+* overflow it.
+*
+* ChainProductBatch holds many independent chains which are
+* multiplied in lockstep, one matrix per chain and step, with
+* branch-free loops over blocks of chains split over the
+* ThreadPool.
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+#ifndef CHAINPRODUCT_H
+#define CHAINPRODUCT_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Mat2x2.h"
+#include "Mat2x2Batch.h"
+
+class ChainProduct{
+  private:
+    Mat2x2 state; // the normalized product
+    int64_t scale; // the exponent
+    uint64_t count;
+    size_t interval;
+  public:
+    explicit ChainProduct(size_t interval = 8); // ctor, throws invalid_argument error for an interval of 0
+
+    void multiply(const Mat2x2 &mat); // P = mat * P
+    void renormalize(); // renormalizes now instead of at the next interval
+    void reset(); // P = identity
+
+    Mat2x2 normalized() const;
+    int64_t exponent() const;
+    uint64_t steps() const;
+    double logNorm() const;
+    double lyapunovExponent() const; // NaN before the first step
+};
+
+class ChainProductBatch{
+  private:
+    Mat2x2Batch<double> state;
+    std::vector<int64_t> scale;
+    uint64_t count;
+    size_t interval;
+  public:
+    // ctor, throws invalid_argument error for an interval of 0
+    explicit ChainProductBatch(size_t chains, size_t interval = 8);
+
+    void multiply(const Mat2x2BatchView<const double> &mats); // P[i] = mats[i] * P[i]
+    void renormalize();
+    void reset();
+
+    size_t size() const;
+    uint64_t steps() const;
+    void normalized(const Mat2x2BatchView<double> &out) const;
+    void exponents(int64_t *out) const;
+    void logNorms(double *out) const;
+    void lyapunovExponents(double *out) const;
+};
+#endif
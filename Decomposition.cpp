@@ -0,0 +1,289 @@
+//-----------------------------------------------
+/**
+* This is the implementation file for the singular value and
+* polar decompositions.
+*
+* With E = (a+d)/2, F = (a-d)/2, G = (c+b)/2 and H = (c-b)/2
+* every matrix is the sum of a scaled rotation and a scaled
+* reflection
+*
+* |a  b|   |E  -H|   |F   G|
+* |    | = |     | + |     |
+* |c  d|   |H   E|   |G  -F|
+*
+* with a*d - b*c = (E^2 + H^2) - (F^2 + G^2). The orthogonal
+* factor of the polar decomposition is the rotation with
+* cos = E / |(E, H)| and sin = H / |(E, H)| when the
+* determinant isn't negative, and otherwise the reflection
+*
+* |cos2   sin2|
+* |           |
+* |sin2  -cos2|
+*
+* with cos2 = F / |(F, G)| and sin2 = G / |(F, G)|.
+*
+* One matrix and a batch go through the same code, the batch
+* in blocks of 64 matrices.
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include "Compensated.h"
+#include "Decomposition.h"
+#include "Parallel.h"
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+  const size_t matricesPerTask = 4096;
+  const size_t blockSize = 64;
+
+  //-----------------------------------------------
+  /*
+  * This is a helper method which replaces x[i] by its square
+  * root. The compiler doesn't vectorize sqrt because it may
+  * have to set errno, all the arguments here are sums of
+  * squares so the SIMD square root is the same.
+  */
+  //-----------------------------------------------
+  void squareRoots(double *x, size_t count){
+    size_t i = 0;
+#if defined(__AVX__)
+    for(; i + 4 <= count; i += 4){
+      _mm256_storeu_pd(x + i, _mm256_sqrt_pd(_mm256_loadu_pd(x + i)));
+    }
+#elif defined(__SSE2__)
+    for(; i + 2 <= count; i += 2){
+      _mm_storeu_pd(x + i, _mm_sqrt_pd(_mm_loadu_pd(x + i)));
+    }
+#endif
+    for(; i < count; i++){
+      x[i] = sqrt(x[i]);
+    }
+  }
+
+  //-----------------------------------------------
+  /*
+  * This is a block of at most blockSize matrices which goes
+  * through the decomposition in passes, every pass is a
+  * branch-free loop over local arrays and the square roots
+  * are taken in between by squareRoots.
+  */
+  //-----------------------------------------------
+  struct Block{
+    size_t count;
+    double a[blockSize], b[blockSize], c[blockSize], d[blockSize];
+    double q11[blockSize], q12[blockSize], q21[blockSize], q22[blockSize]; // orthogonal factor
+    double s11[blockSize], s12[blockSize], s22[blockSize], determinant[blockSize];
+    double root[blockSize], length[blockSize];
+
+    void load(const Mat2x2BatchView<const double> &in, size_t first, size_t count1){
+      count = count1;
+      memcpy(a, in.a + first, count * sizeof(double));
+      memcpy(b, in.b + first, count * sizeof(double));
+      memcpy(c, in.c + first, count * sizeof(double));
+      memcpy(d, in.d + first, count * sizeof(double));
+    }
+
+    //-----------------------------------------------
+    /*
+    * This method finds the polar decomposition. The sign of
+    * the compensated determinant picks the rotation of (E, H)
+    * or the reflection of (F, G), the zero matrix gets the
+    * identity. The stretch is S = Q^T * M, where the two off
+    * diagonal elements only differ by rounding, and it is
+    * positive semi-definite because Q is the orthogonal matrix
+    * closest to M.
+    */
+    //-----------------------------------------------
+    void polar(){
+      for(size_t i = 0; i < count; i++){
+        determinant[i] = compensatedDeterminant(a[i], b[i], c[i], d[i]);
+        double sign = determinant[i] < 0 ? -1.0 : 1.0; // det(Q)
+        double x = (a[i] + (sign * d[i])) * 0.5; // E or F
+        double y = (c[i] - (sign * b[i])) * 0.5; // H or G
+        root[i] = (x * x) + (y * y);
+      }
+      squareRoots(root, count);
+      for(size_t i = 0; i < count; i++){
+        double sign = determinant[i] < 0 ? -1.0 : 1.0;
+        double x = (a[i] + (sign * d[i])) * 0.5;
+        double y = (c[i] - (sign * b[i])) * 0.5;
+        double zero = root[i] == 0 ? 1.0 : 0.0; // x = y = 0, the identity
+        double scale = 1 / (root[i] + zero);
+        double cos = (x * scale) + zero, sin = y * scale;
+        q11[i] = cos;
+        q12[i] = -sign * sin;
+        q21[i] = sin;
+        q22[i] = sign * cos;
+        s11[i] = (q11[i] * a[i]) + (q21[i] * c[i]);
+        s12[i] = (((q11[i] * b[i]) + (q21[i] * d[i])) + ((q12[i] * a[i]) + (q22[i] * c[i]))) * 0.5;
+        s22[i] = (q12[i] * b[i]) + (q22[i] * d[i]);
+      }
+    }
+
+    //-----------------------------------------------
+    /*
+    * This method finds the singular value decomposition from
+    * the polar one, V holds the eigenvectors of S and U = Q * V.
+    * The eigenvalues of S are m +- n with m = (s11 + s22)/2 and
+    * n = |((s11 - s22)/2, s12)|, the eigenvector of m + n is
+    * found with the half angle formula, picking the form which
+    * doesn't cancel. The second singular value is |det| / s1
+    * rather than m - n, which cancels for a matrix close to
+    * rank one. The two forms are blended with a 0 or 1 weight
+    * instead of a select, which the compiler doesn't if-convert
+    * because the unused form could raise a floating point
+    * exception.
+    */
+    //-----------------------------------------------
+    void svd(double *u11, double *u12, double *u21, double *u22, double *sigma1, double *sigma2,
+             double *v11, double *v12, double *v21, double *v22){
+      polar();
+      for(size_t i = 0; i < count; i++){
+        double half = (s11[i] - s22[i]) * 0.5;
+        root[i] = (half * half) + (s12[i] * s12[i]);
+      }
+      squareRoots(root, count);
+      for(size_t i = 0; i < count; i++){
+        double half = (s11[i] - s22[i]) * 0.5;
+        double first = half >= 0 ? 1.0 : 0.0;
+        double x = (first * (root[i] + half)) + ((1 - first) * s12[i]);
+        double y = (first * s12[i]) + ((1 - first) * (root[i] - half));
+        length[i] = (x * x) + (y * y);
+      }
+      squareRoots(length, count);
+      for(size_t i = 0; i < count; i++){
+        double half = (s11[i] - s22[i]) * 0.5;
+        double first = half >= 0 ? 1.0 : 0.0;
+        double x = (first * (root[i] + half)) + ((1 - first) * s12[i]);
+        double y = (first * s12[i]) + ((1 - first) * (root[i] - half));
+        double repeated = length[i] == 0 ? 1.0 : 0.0; // S is a multiple of the identity
+        double scale = 1 / (length[i] + repeated);
+        double vx = (x * scale) + repeated, vy = y * scale;
+        double s1 = ((s11[i] + s22[i]) * 0.5) + root[i];
+        u11[i] = (q11[i] * vx) + (q12[i] * vy);
+        u12[i] = (q12[i] * vx) - (q11[i] * vy);
+        u21[i] = (q21[i] * vx) + (q22[i] * vy);
+        u22[i] = (q22[i] * vx) - (q21[i] * vy);
+        sigma1[i] = s1;
+        double s2 = fabs(determinant[i]) / (s1 + (s1 > 0 ? 0.0 : 1.0));
+        sigma2[i] = s2 < s1 ? s2 : s1; // equal singular values may round the other way
+        v11[i] = vx;
+        v12[i] = -vy;
+        v21[i] = vy;
+        v22[i] = vx;
+      }
+    }
+  };
+
+  template <typename T, typename U>
+  void checkSizes(const Mat2x2BatchView<T> &in, const Mat2x2BatchView<U> &out){
+    if(in.size != out.size){
+      throw invalid_argument("invalid argument");
+    }
+  }
+
+  //-----------------------------------------------
+  /*
+  * This is a helper method which splits [0, count) in blocks
+  * over the ThreadPool and calls fn(first, last) on each.
+  */
+  //-----------------------------------------------
+  template <typename Function>
+  void forEachBlock(size_t count, Function fn){
+    size_t tasks = (count + matricesPerTask - 1) / matricesPerTask;
+    parallelFor(ThreadPool::instance(), 0, tasks, 1, [&](size_t task){
+      size_t first = task * matricesPerTask;
+      fn(first, count - first < matricesPerTask ? count : first + matricesPerTask);
+    });
+  }
+}
+
+//-----------------------------------------------
+/*
+* Following functions decompose one matrix, see
+* Decomposition.h
+*/
+//-----------------------------------------------
+Mat2x2Svd svd(const Mat2x2 &mat){
+  Mat2x2Svd temp;
+  Block block;
+  double in[4], u[4], v[4];
+  mat.getElements(in);
+  block.load(Mat2x2BatchView<const double>(in, in + 1, in + 2, in + 3, 1), 0, 1);
+  block.svd(u, u + 1, u + 2, u + 3, &temp.sigma1, &temp.sigma2, v, v + 1, v + 2, v + 3);
+  temp.u.setElements(u);
+  temp.v.setElements(v);
+  return temp;
+}
+
+Mat2x2Polar polar(const Mat2x2 &mat){
+  Mat2x2Polar temp;
+  Block block;
+  double in[4];
+  mat.getElements(in);
+  block.load(Mat2x2BatchView<const double>(in, in + 1, in + 2, in + 3, 1), 0, 1);
+  block.polar();
+  temp.orthogonal = Mat2x2(block.q11[0], block.q12[0], block.q21[0], block.q22[0]);
+  temp.stretch = Mat2x2(block.s11[0], block.s12[0], block.s12[0], block.s22[0]);
+  return temp;
+}
+
+//-----------------------------------------------
+/*
+* Following functions decompose every matrix of a batch, the
+* outputs may be the same views as in. The results of a block
+* are written to local arrays first and then copied out.
+*/
+//-----------------------------------------------
+void batchSvd(const Mat2x2BatchView<const double> &in, const Mat2x2BatchView<double> &u,
+              double *sigma1, double *sigma2, const Mat2x2BatchView<double> &v){
+  checkSizes(in, u);
+  checkSizes(in, v);
+  forEachBlock(in.size, [&](size_t first, size_t last){
+    Block block;
+    double out[10][blockSize];
+    double *dst[10] = {u.a, u.b, u.c, u.d, sigma1, sigma2, v.a, v.b, v.c, v.d};
+    for(; first < last; first += blockSize){
+      size_t count = last - first < blockSize ? last - first : blockSize;
+      block.load(in, first, count);
+      block.svd(out[0], out[1], out[2], out[3], out[4], out[5], out[6], out[7], out[8], out[9]);
+      for(int k = 0; k < 10; k++){
+        memcpy(dst[k] + first, out[k], count * sizeof(double));
+      }
+    }
+  });
+}
+
+void batchPolar(const Mat2x2BatchView<const double> &in, const Mat2x2BatchView<double> &orthogonal,
+                const Mat2x2BatchView<double> &stretch){
+  checkSizes(in, orthogonal);
+  checkSizes(in, stretch);
+  forEachBlock(in.size, [&](size_t first, size_t last){
+    Block block;
+    for(; first < last; first += blockSize){
+      size_t count = last - first < blockSize ? last - first : blockSize;
+      size_t bytes = count * sizeof(double);
+      block.load(in, first, count);
+      block.polar();
+      memcpy(orthogonal.a + first, block.q11, bytes);
+      memcpy(orthogonal.b + first, block.q12, bytes);
+      memcpy(orthogonal.c + first, block.q21, bytes);
+      memcpy(orthogonal.d + first, block.q22, bytes);
+      memcpy(stretch.a + first, block.s11, bytes);
+      memcpy(stretch.b + first, block.s12, bytes);
+      memcpy(stretch.c + first, block.s12, bytes);
+      memcpy(stretch.d + first, block.s22, bytes);
+    }
+  });
+}
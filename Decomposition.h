@@ -0,0 +1,89 @@
+//-----------------------------------------------
+/**
+* This is the header file for the closed form singular value
+* and polar decompositions of Mat2x2 objects.
+*
+* The polar decomposition is the standard M = Q * S, where Q is
+* the orthogonal matrix closest to M and S = Q^T * M is
+* symmetric positive semi-definite. Q is the rotation
+*
+* |cos  -sin|
+* |         |
+* |sin   cos|
+*
+* when the determinant of M isn't negative and the reflection
+*
+* |cos   sin|
+* |         |
+* |sin  -cos|
+*
+* when it is, so det(Q) has the sign of det(M).
+*
+* The singular value decomposition is M = U * diag(s1, s2) * V^T
+* with s1 >= s2 >= 0, V a rotation and U a rotation or, for a
+* negative determinant, a reflection. It is found from the
+* polar decomposition, V holds the eigenvectors of S and
+* U = Q * V.
+*
+* Both are a fixed sequence of products, square roots and
+* selects, no trigonometric functions and no iterations, so
+* the batch versions vectorize and are split over the
+* ThreadPool. The singular values are computed as sums of
+* squares, so the elements must be smaller than about 1.e150
+* in magnitude.
+*
+* Accuracy against a __float128 reference, measured with
+* "decomposition" in bench/bench.cpp over 2^18 matrices of
+* each kind with elements in [-1, 1]: random, random with a
+* negative determinant, rank one plus a perturbation of
+* 1.e-12, exactly rank one, and a scaled rotation or
+* reflection with a stretch of 1.e-10 (two almost equal
+* singular values). Every error is relative to s1 except
+* orthogonal, the largest error of U^T * U, V^T * V and
+* Q^T * Q against the identity. S < 0 is how far the smallest
+* eigenvalue of S is below zero:
+*
+* input            s1       s2       orthogonal  U*S*V^T  Q*S      S < 0
+* ---------------  -------  -------  ----------  -------  -------  -------
+* random           4.8e-16  4.9e-16  9.8e-16     9.8e-16  5.6e-16  0
+* det < 0          4.6e-16  4.6e-16  1.0e-15     1.0e-15  5.5e-16  0
+* near rank one    5.2e-16  8.7e-26  1.0e-15     9.7e-16  6.3e-16  2.9e-17
+* rank one         3.7e-16  0        7.3e-16     6.7e-16  3.7e-16  1.0e-16
+* near conformal   5.8e-16  7.2e-16  9.8e-16     1.0e-15  6.7e-16  0
+* near reflection  6.4e-16  6.9e-16  9.9e-16     1.1e-15  6.4e-16  0
+*
+* s2 is |a*d - b*c| / s1 with the compensated determinant of
+* Compensated.h, so it is also accurate relative to itself.
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+#ifndef DECOMPOSITION_H
+#define DECOMPOSITION_H
+#include <cstddef>
+#include "Mat2x2.h"
+#include "Mat2x2Batch.h"
+
+struct Mat2x2Svd{
+  Mat2x2 u;
+  double sigma1, sigma2; // singular values, sigma1 >= sigma2 >= 0
+  Mat2x2 v;
+};
+
+struct Mat2x2Polar{
+  Mat2x2 orthogonal; // a rotation, or a reflection when the determinant is negative
+  Mat2x2 stretch; // symmetric positive semi-definite
+};
+
+Mat2x2Svd svd(const Mat2x2 &mat);
+Mat2x2Polar polar(const Mat2x2 &mat);
+
+// batch versions, every view must have the size of in otherwise they throw invalid_argument error,
+// sigma1 and sigma2 must hold in.size elements
+void batchSvd(const Mat2x2BatchView<const double> &in, const Mat2x2BatchView<double> &u,
+              double *sigma1, double *sigma2, const Mat2x2BatchView<double> &v);
+void batchPolar(const Mat2x2BatchView<const double> &in, const Mat2x2BatchView<double> &orthogonal,
+                const Mat2x2BatchView<double> &stretch);
+#endif
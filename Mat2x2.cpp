@@ -11,6 +11,8 @@
 * If no variables are provided then it initializes the values to
 * zeros
 
+* Compiled with -DMAT2X2_TRACE every public operation can be
+* recorded to a trace file, see Trace.h
 *
 * @author  Mandeep Ahlawat
 * @version 1.0
@@ -18,6 +20,7 @@
 */
 //-----------------------------------------------
 
+#include <algorithm>
 #include <iostream>
 #include <cassert>
 #include <iomanip>
@@ -27,9 +30,28 @@
 #include <cmath>
 #include <vector>
 #include "Mat2x2.h"
+#include "Compensated.h"
+#ifdef MAT2X2_TRACE
+#include "Trace.h"
+#else
+#define MAT2X2_TRACE_SCOPE(...)
+#define MAT2X2_TRACE_OPERAND(mat)
+#endif
 
 using namespace std;
 
+namespace {
+  //-----------------------------------------------
+  /*
+  * This is a helper method which compares two values with
+  * the tolerance of operator==, exp(-6), which is absolute
+  * up to a magnitude of 1 and relative above it.
+  */
+  //-----------------------------------------------
+  bool isClose(double x, double y){
+    return fabs(x - y) < exp(-6) * max(1.0, max(fabs(x), fabs(y)));
+  }
+}
 
 //-----------------------------------------------
 /*
@@ -51,12 +73,15 @@ Mat2x2::Mat2x2(double a1, double b1, double c1, double d1) : a(a1), b(b1), c(c1)
 *             (-c, a)
 *
 * if the denominator part, i.e ((a*d) - (b*c)) is zero
-* then it throws overflow error
+* then it throws overflow error. The denominator is
+* preciseDeterminant(), so a matrix close to singular isn't
+* accepted or rejected because of cancellation.
 */
 //-----------------------------------------------
 Mat2x2 Mat2x2::inverse() const{
+  MAT2X2_TRACE_SCOPE(TraceOp::Inverse, *this);
   Mat2x2 temp(d, - b, - c, a);
-  double denominator = ((a * d) - (b * c));
+  double denominator = preciseDeterminant();
   if(denominator <= exp(-6)){
     throw std::overflow_error("Inverse undefined");
   }
@@ -64,6 +89,34 @@ Mat2x2 Mat2x2::inverse() const{
   return temp;
 }
 
+//-----------------------------------------------
+/*
+* This function is the non-throwing version of inverse(),
+* it stores the inverse of the matrix in result and returns
+* true, or returns false and leaves result unchanged if the
+* inverse can't be represented, i.e the denominator
+* ((a*d) - (b*c)) is zero or not finite, or so small that its
+* reciprocal overflows.
+*
+* Unlike inverse() it accepts any other denominator, so it
+* can be used for matrices with small or negative determinants
+* such as the pivots of a solver.
+*/
+//-----------------------------------------------
+bool Mat2x2::tryInverse(Mat2x2 &result) const{
+  MAT2X2_TRACE_SCOPE(TraceOp::TryInverse, *this);
+  double denominator = preciseDeterminant();
+  if(!std::isfinite(denominator)){
+    return false;
+  }
+  double scale = 1 / denominator;
+  if(!std::isfinite(scale)){
+    return false;
+  }
+  result = Mat2x2(d * scale, - b * scale, - c * scale, a * scale);
+  return true;
+}
+
 //-----------------------------------------------
 /*
 * This finds the transpose of the matrix without
@@ -74,21 +127,47 @@ Mat2x2 Mat2x2::inverse() const{
 */
 //-----------------------------------------------
 Mat2x2 Mat2x2::transpose() const{
+  MAT2X2_TRACE_SCOPE(TraceOp::Transpose, *this);
   Mat2x2 temp(a, c, b, d);
   return temp;
 }
 
 //-----------------------------------------------
 /*
-* This finds the transpose of the matrix without
-* modyfying the actually object
-*
-* transpose of a matrix is a mirror immage along its diagonals
-* for a 2x2 matrix it just interchange b and c elements
+* This function returns the determinant, i.e
+* ((a*d) - (b*c)), truncated to an integer
 */
 //-----------------------------------------------
 int Mat2x2::determinant() const{
-  return (int) ((a*d) - (b*c));
+  MAT2X2_TRACE_SCOPE(TraceOp::Determinant, *this);
+  return (int) preciseDeterminant();
+}
+
+//-----------------------------------------------
+/*
+* This function returns ((a*d) - (b*c)) as a double,
+* the rounding error of the products is added back with
+* Kahan's algorithm (see Compensated.h), so the result is
+* accurate even when the two products almost cancel.
+*/
+//-----------------------------------------------
+double Mat2x2::preciseDeterminant() const{
+  MAT2X2_TRACE_SCOPE(TraceOp::PreciseDeterminant, *this);
+  return compensatedDeterminant(a, b, c, d);
+}
+
+//-----------------------------------------------
+/*
+* This function returns the discriminant of the
+* characteristic polynomial, pow(a + d, 2) - 4 * ((a*d) - (b*c)),
+* which is computed as pow(a - d, 2) + 4*b*c with the
+* rounding errors added back. It is negative when the
+* eigenvalues are complex.
+*/
+//-----------------------------------------------
+double Mat2x2::discriminant() const{
+  MAT2X2_TRACE_SCOPE(TraceOp::Discriminant, *this);
+  return compensatedDiscriminant(a, b, c, d);
 }
 
 //-----------------------------------------------
@@ -99,6 +178,7 @@ int Mat2x2::determinant() const{
 */
 //-----------------------------------------------
 int Mat2x2::trace() const{
+  MAT2X2_TRACE_SCOPE(TraceOp::Trace, *this);
   return (int) (a + d);
 }
 
@@ -112,6 +192,7 @@ int Mat2x2::trace() const{
 */
 //-----------------------------------------------
 bool Mat2x2::isSymmetric() const{
+  MAT2X2_TRACE_SCOPE(TraceOp::IsSymmetric, *this);
   if(b == c){
       return true;
   }
@@ -125,12 +206,16 @@ bool Mat2x2::isSymmetric() const{
 * not and returns the boolean value accordingly
 * 
 * A matrix is called similar if both the determinant and
-* trace of the matrices is same.
+* trace of the matrices is same. Both are compared with
+* the exp(-6) tolerance of operator==, relative to their
+* magnitude when it is above 1, so T * M * T^-1 is still
+* similar to M after its rounding errors.
 * 
 */
 //-----------------------------------------------
 bool Mat2x2::isSimilar(const Mat2x2 &mat) const{
-  return (this->determinant() == mat.determinant() && this->trace() == mat.trace());
+  MAT2X2_TRACE_SCOPE(TraceOp::IsSimilar, *this, mat);
+  return (isClose(this->preciseDeterminant(), mat.preciseDeterminant()) && isClose(a + d, mat.a + mat.d));
 }
 
 
@@ -149,6 +234,7 @@ bool Mat2x2::isSimilar(const Mat2x2 &mat) const{
 */
 //-----------------------------------------------
 Mat2x2 &Mat2x2::operator+=(double x){
+  MAT2X2_TRACE_SCOPE(TraceOp::AddAssignScalar, *this, x);
   a += x;
   b += x;
   c += x;
@@ -158,6 +244,7 @@ Mat2x2 &Mat2x2::operator+=(double x){
 }
 
 Mat2x2 &Mat2x2::operator-=(double x){
+  MAT2X2_TRACE_SCOPE(TraceOp::SubtractAssignScalar, *this, x);
   a -= x;
   b -= x;
   c -= x;
@@ -167,6 +254,7 @@ Mat2x2 &Mat2x2::operator-=(double x){
 }
 
 Mat2x2 &Mat2x2::operator*=(double x){
+  MAT2X2_TRACE_SCOPE(TraceOp::MultiplyAssignScalar, *this, x);
   a *= x;
   b *= x;
   c *= x;
@@ -176,6 +264,7 @@ Mat2x2 &Mat2x2::operator*=(double x){
 }
 
 Mat2x2 &Mat2x2::operator/=(double x){
+  MAT2X2_TRACE_SCOPE(TraceOp::DivideAssignScalar, *this, x);
   if(x == 0){
     throw std::overflow_error("Division by zero"); // throw overflow error if divide by 0
   }
@@ -201,6 +290,7 @@ Mat2x2 &Mat2x2::operator/=(double x){
 */
 //-----------------------------------------------
 Mat2x2 &Mat2x2::operator+=(const Mat2x2 &mat){
+  MAT2X2_TRACE_SCOPE(TraceOp::AddAssign, *this, mat);
   a += mat.a;
   b += mat.b;
   c += mat.c;
@@ -209,6 +299,7 @@ Mat2x2 &Mat2x2::operator+=(const Mat2x2 &mat){
 }
 
 Mat2x2 &Mat2x2::operator-=(const Mat2x2 &mat){
+  MAT2X2_TRACE_SCOPE(TraceOp::SubtractAssign, *this, mat);
   a -= mat.a;
   b -= mat.b;
   c -= mat.c;
@@ -217,6 +308,7 @@ Mat2x2 &Mat2x2::operator-=(const Mat2x2 &mat){
 }
 
 Mat2x2 &Mat2x2::operator*=(const Mat2x2 &mat){
+  MAT2X2_TRACE_SCOPE(TraceOp::MultiplyAssign, *this, mat);
   double a1, a2, a3, a4;
   a1 = (a * mat.a) + (b * mat.c);
   a2 = (a * mat.b) + (b * mat.d);
@@ -231,6 +323,7 @@ Mat2x2 &Mat2x2::operator*=(const Mat2x2 &mat){
 }
 
 Mat2x2 &Mat2x2::operator/=(const Mat2x2 &mat){
+  MAT2X2_TRACE_SCOPE(TraceOp::DivideAssign, *this, mat);
   Mat2x2 temp = mat.inverse();
   *this *= temp;
   return *this;
@@ -249,6 +342,7 @@ Mat2x2 &Mat2x2::operator/=(const Mat2x2 &mat){
 */
 //-----------------------------------------------
 bool operator==(const Mat2x2 &matLhs, const Mat2x2 &matRhs){
+  MAT2X2_TRACE_SCOPE(TraceOp::Equal, matLhs, matRhs);
   if((fabs(matLhs.a - matRhs.a) < exp(-6)) && fabs(matLhs.b - matRhs.b) < exp(-6) && fabs(matLhs.c - matRhs.c) < exp(-6) && fabs(matLhs.d - matRhs.d) < exp(-6)){
       return true;
   }
@@ -264,6 +358,7 @@ bool operator==(const Mat2x2 &matLhs, const Mat2x2 &matRhs){
 */
 //-----------------------------------------------
 bool operator!=(const Mat2x2 &matLhs, const Mat2x2 &matRhs){
+  MAT2X2_TRACE_SCOPE(TraceOp::NotEqual, matLhs, matRhs);
   return !(matLhs == matRhs);
 }
 
@@ -288,12 +383,14 @@ bool operator!=(const Mat2x2 &matLhs, const Mat2x2 &matRhs){
 */
 //-----------------------------------------------
 Mat2x2 operator*(const Mat2x2 &matLhs, const Mat2x2 &matRhs){
+  MAT2X2_TRACE_SCOPE(TraceOp::Multiply, matLhs, matRhs);
   Mat2x2 temp = matLhs;
   temp *= matRhs;
   return temp;
 }
 
 Mat2x2 operator*(double x, const Mat2x2 &matRhs){
+  MAT2X2_TRACE_SCOPE(TraceOp::ScalarMultiply, matRhs, x);
   Mat2x2 temp;
   temp = matRhs;
   temp *= x;
@@ -301,6 +398,7 @@ Mat2x2 operator*(double x, const Mat2x2 &matRhs){
 }
 
 Mat2x2 operator*(const Mat2x2 &matRhs, double x){
+  MAT2X2_TRACE_SCOPE(TraceOp::MultiplyScalar, matRhs, x);
   return (x * matRhs);
 }
 
@@ -324,18 +422,21 @@ Mat2x2 operator*(const Mat2x2 &matRhs, double x){
 */
 //-----------------------------------------------
 Mat2x2 operator/(const Mat2x2 &matLhs, const Mat2x2 &matRhs){
+  MAT2X2_TRACE_SCOPE(TraceOp::Divide, matLhs, matRhs);
   Mat2x2 temp = matLhs;
   temp /= matRhs;
   return temp;
 }
 
 Mat2x2 operator/(double x, const Mat2x2 &mat){
+  MAT2X2_TRACE_SCOPE(TraceOp::ScalarDivide, mat, x);
   Mat2x2 temp = mat.inverse();
   temp *= x;
   return temp;
 }
 
 Mat2x2 operator/(const Mat2x2 &mat, double x){
+  MAT2X2_TRACE_SCOPE(TraceOp::DivideScalar, mat, x);
   Mat2x2 temp = mat;
   temp /= x;
   return temp;
@@ -361,18 +462,21 @@ Mat2x2 operator/(const Mat2x2 &mat, double x){
 */
 //-----------------------------------------------
 Mat2x2 operator+(const Mat2x2 &matLhs, const Mat2x2 &matRhs){
+  MAT2X2_TRACE_SCOPE(TraceOp::Add, matLhs, matRhs);
   Mat2x2 temp = matLhs;
   temp += matRhs;
   return temp;
 }
 
 Mat2x2 operator+(double x, const Mat2x2 &mat){
+  MAT2X2_TRACE_SCOPE(TraceOp::ScalarAdd, mat, x);
   Mat2x2 temp = mat;
   temp += x;
   return temp;
 }
 
 Mat2x2 operator+(const Mat2x2 &mat, double x){
+  MAT2X2_TRACE_SCOPE(TraceOp::AddScalar, mat, x);
   return (x + mat);
 }
 
@@ -396,18 +500,21 @@ Mat2x2 operator+(const Mat2x2 &mat, double x){
 */
 //-----------------------------------------------
 Mat2x2 operator-(const Mat2x2 &matLhs, const Mat2x2 &matRhs){
+  MAT2X2_TRACE_SCOPE(TraceOp::Subtract, matLhs, matRhs);
   Mat2x2 temp = matLhs;
   temp -= matRhs;
   return temp;
 }
 
 Mat2x2 operator-(const Mat2x2 &mat, double x){
+  MAT2X2_TRACE_SCOPE(TraceOp::SubtractScalar, mat, x);
   Mat2x2 temp = mat;
   temp -= x;
   return temp;
 }
 
 Mat2x2 operator-(double x, const Mat2x2 &mat){
+  MAT2X2_TRACE_SCOPE(TraceOp::ScalarSubtract, mat, x);
   return -(mat - x);
 }
 
@@ -422,6 +529,7 @@ Mat2x2 operator-(double x, const Mat2x2 &mat){
 */
 //-----------------------------------------------
 const double &Mat2x2::operator[](const int x) const {
+  MAT2X2_TRACE_SCOPE(TraceOp::ConstSubscript, *this, x);
   switch (x) {
     case 0:
       return a;
@@ -454,6 +562,7 @@ const double &Mat2x2::operator[](const int x) const {
 */
 //-----------------------------------------------
 double &Mat2x2::operator[](const int x){
+  MAT2X2_TRACE_SCOPE(TraceOp::Subscript, *this, x);
   switch (x) {
     case 0:
       return a;
@@ -485,22 +594,26 @@ double &Mat2x2::operator[](const int x){
 */
 //-----------------------------------------------
 Mat2x2& Mat2x2::operator++(){
+  MAT2X2_TRACE_SCOPE(TraceOp::PreIncrement, *this);
   *this += 1;
   return *this;
 }
 
 Mat2x2 Mat2x2::operator++(int x){
+  MAT2X2_TRACE_SCOPE(TraceOp::PostIncrement, *this);
   Mat2x2 temp = *this;
   *this += 1;
   return temp;
 }
 
 Mat2x2& Mat2x2::operator--(){
+  MAT2X2_TRACE_SCOPE(TraceOp::PreDecrement, *this);
   *this -= 1;
   return *this;
 }
 
 Mat2x2 Mat2x2::operator--(int x){
+  MAT2X2_TRACE_SCOPE(TraceOp::PostDecrement, *this);
   Mat2x2 temp = *this;
   *this -= 1;
   return temp;
@@ -521,11 +634,13 @@ Mat2x2 Mat2x2::operator--(int x){
 */
 //-----------------------------------------------
 Mat2x2 Mat2x2::operator+(){
+  MAT2X2_TRACE_SCOPE(TraceOp::UnaryPlus, *this);
   Mat2x2 temp = *this;
   return temp;
 }
 
 Mat2x2 Mat2x2::operator-(){
+  MAT2X2_TRACE_SCOPE(TraceOp::UnaryMinus, *this);
   Mat2x2 temp = *this;
   temp = -1 * temp;
   return temp;
@@ -548,12 +663,17 @@ Mat2x2 Mat2x2::operator-(){
 * since sqrt(pow(trace(M), 2) - 4 * (determinant(M))) can be either positive
 * or negative so this function either contains vector of size 1 or size 2
 * for positive and negative values of the sqrt part.
+*
+* The sqrt part is discriminant() and the trace isn't truncated,
+* for real eigenvalues the one which would cancel is found
+* from eigen1 * eigen2 = determinant(M) instead.
 */
 //-----------------------------------------------
 vector<double> Mat2x2::operator()(int x){
+  MAT2X2_TRACE_SCOPE(TraceOp::Eigenvalue, *this, x);
   bool complex = false;
   vector<double> temp;
-  double sqrtPart = (pow(trace(), 2) - 4 * (determinant()));
+  double sqrtPart = discriminant();
   if(sqrtPart >= 0){
       sqrtPart = sqrt(sqrtPart)/2;
   }
@@ -561,10 +681,12 @@ vector<double> Mat2x2::operator()(int x){
       complex = true;
       sqrtPart = sqrt(-sqrtPart)/2;
   }
-  double realPart = trace()/2;
+  double realPart = (a + d)/2;
+  double larger = realPart >= 0 ? realPart + sqrtPart : realPart - sqrtPart;
+  double smaller = larger != 0 ? preciseDeterminant() / larger : 0;
   if(x == 1){
       if(!complex){
-          temp.push_back(realPart + sqrtPart);
+          temp.push_back(realPart >= 0 ? larger : smaller);
       }
       else{
           temp.push_back(realPart);
@@ -574,7 +696,7 @@ vector<double> Mat2x2::operator()(int x){
   }
   else if(x == 2){
       if(!complex){
-          temp.push_back(realPart - sqrtPart);
+          temp.push_back(realPart >= 0 ? smaller : larger);
       }
       else{
           temp.push_back(realPart);
@@ -597,6 +719,7 @@ vector<double> Mat2x2::operator()(int x){
 */
 //-----------------------------------------------
 int Mat2x2::operator()(){
+  MAT2X2_TRACE_SCOPE(TraceOp::DeterminantCall, *this);
   return (determinant());
 }
 
@@ -611,6 +734,7 @@ int Mat2x2::operator()(){
 */
 //-----------------------------------------------
 ostream &operator<<(ostream &cout, const Mat2x2 &mat){
+  MAT2X2_TRACE_SCOPE(TraceOp::Output, mat);
   int leftWidthLength = mat.maxLeftMemLength(); // get max width of the left side members, i.e a and c
   int rightWidthLength = mat.maxRightMemLength(); // get max width of the right side members, i.e b and d
   cout << fixed << setprecision(2);
@@ -631,6 +755,7 @@ ostream &operator<<(ostream &cout, const Mat2x2 &mat){
 */
 //-----------------------------------------------
 istream &operator>>(istream &in, Mat2x2 &mat){
+  MAT2X2_TRACE_SCOPE(TraceOp::Input, mat);
   double a1, a2, a3, a4;
   cout << "To create the following 2*2 matrix:" << endl;
   cout << "|a  b|" << endl;
@@ -640,6 +765,7 @@ istream &operator>>(istream &in, Mat2x2 &mat){
   in >> a1 >> a2 >> a3 >> a4;
   Mat2x2 temp(a1, a2, a3, a4);
   mat = temp;
+  MAT2X2_TRACE_OPERAND(mat);
   return in;
 }
 
@@ -50,8 +50,11 @@ class Mat2x2{
 
     // matrix related operations
     Mat2x2 inverse() const;
+    bool tryInverse(Mat2x2 &result) const; // non-throwing inverse
     Mat2x2 transpose() const;
     int determinant() const;
+    double preciseDeterminant() const; // a*d - b*c without cancellation or truncation
+    double discriminant() const; // trace^2 - 4*determinant without cancellation
     int trace() const;
     bool isSymmetric() const;
     bool isSimilar(const Mat2x2 &mat) const;
@@ -60,6 +63,20 @@ class Mat2x2{
     const double &operator[](const int) const;
     double &operator[](const int);
 
+    // copy the elements to and from a row-major array {a, b, c, d}, inline for the bulk conversions
+    void getElements(double *elements) const{
+      elements[0] = a;
+      elements[1] = b;
+      elements[2] = c;
+      elements[3] = d;
+    }
+    void setElements(const double *elements){
+      a = elements[0];
+      b = elements[1];
+      c = elements[2];
+      d = elements[3];
+    }
+
     // function objects
     std::vector<double> operator()(int);
     int operator()();
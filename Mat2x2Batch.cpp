@@ -0,0 +1,268 @@
+//-----------------------------------------------
+/**
+* This is the implementation file for the Mat2x2Batch kernels.
+* Every kernel is a loop over the element arrays without
+* branches, so the compiler can vectorize it, check with
+* -fopt-info-vec-optimized after changing one.
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include "Mat2x2Batch.h"
+#include "Compensated.h"
+
+using namespace std;
+
+namespace {
+  template <typename T, typename U>
+  void checkSizes(const Mat2x2BatchView<T> &in, const Mat2x2BatchView<U> &out){
+    if(in.size != out.size){
+      throw invalid_argument("invalid argument");
+    }
+  }
+
+  //-----------------------------------------------
+  /*
+  * The kernels below take every array as a __restrict
+  * pointer. Without it the compiler has to prove at run time
+  * that none of the twelve arrays overlap, gives up on that
+  * many checks and leaves the loop scalar. Acc is the type in
+  * which the products are summed before they are stored as T.
+  */
+  //-----------------------------------------------
+  template <typename Acc, typename T>
+  void multiplyKernel(const T *__restrict la, const T *__restrict lb, const T *__restrict lc, const T *__restrict ld,
+                      const T *__restrict ra, const T *__restrict rb, const T *__restrict rc, const T *__restrict rd,
+                      T *__restrict oa, T *__restrict ob, T *__restrict oc, T *__restrict od, size_t count){
+    for(size_t i = 0; i < count; i++){
+      Acc a = la[i], b = lb[i], c = lc[i], d = ld[i];
+      oa[i] = (T) ((a * ra[i]) + (b * rc[i]));
+      ob[i] = (T) ((a * rb[i]) + (b * rd[i]));
+      oc[i] = (T) ((c * ra[i]) + (d * rc[i]));
+      od[i] = (T) ((c * rb[i]) + (d * rd[i]));
+    }
+  }
+
+  // the determinant which the inverse kernel divides by, compensated for double as in tryInverse()
+  template <typename Acc>
+  inline Acc inverseDenominator(Acc a, Acc b, Acc c, Acc d){
+    return (a * d) - (b * c);
+  }
+
+  template <>
+  inline double inverseDenominator<double>(double a, double b, double c, double d){
+    return compensatedDeterminant(a, b, c, d);
+  }
+
+  //-----------------------------------------------
+  /*
+  * check = denominator * (1 / denominator) is about 1 when the
+  * reciprocal is finite and non-zero, NaN when the denominator
+  * is zero or not finite, and inf when it is so small that its
+  * reciprocal overflows. check / check is then 1 or NaN, so
+  * the rejected matrices get NaN elements without a branch or
+  * a select, which keep the loop from vectorizing. They are
+  * counted on the scale after that, because check itself
+  * isn't NaN in the overflow case. check isn't compared with
+  * 1, x * (1 / x) is 1 - 2^-53 for some x, e.g 49.
+  */
+  //-----------------------------------------------
+  template <typename Acc, typename T>
+  size_t inverseKernel(const T *__restrict ia, const T *__restrict ib, const T *__restrict ic, const T *__restrict id,
+                       T *__restrict oa, T *__restrict ob, T *__restrict oc, T *__restrict od, size_t count){
+    size_t singular = 0;
+    for(size_t i = 0; i < count; i++){
+      Acc a = ia[i], b = ib[i], c = ic[i], d = id[i];
+      Acc denominator = inverseDenominator<Acc>(a, b, c, d);
+      Acc scale = 1 / denominator;
+      Acc check = denominator * scale;
+      scale *= check / check;
+      singular += scale != scale;
+      oa[i] = (T) (d * scale);
+      ob[i] = (T) (-b * scale);
+      oc[i] = (T) (-c * scale);
+      od[i] = (T) (a * scale);
+    }
+    return singular;
+  }
+
+  //-----------------------------------------------
+  /*
+  * An output which overlaps an input breaks the promise of
+  * __restrict, even when it is the same view, because the
+  * vectorized loop may store an element of one array before
+  * it loads the same element of another. Such calls run the
+  * kernel on local copies of blocks of the inputs instead.
+  */
+  //-----------------------------------------------
+  const size_t blockSize = 64;
+
+  template <typename T>
+  bool overlaps(const Mat2x2BatchView<const T> &in, const Mat2x2BatchView<T> &out){
+    const T *inArrays[4] = {in.a, in.b, in.c, in.d};
+    const T *outArrays[4] = {out.a, out.b, out.c, out.d};
+    less<const T *> before;
+    for(int i = 0; i < 4; i++){
+      for(int j = 0; j < 4; j++){
+        if(before(inArrays[i], outArrays[j] + out.size) && before(outArrays[j], inArrays[i] + in.size)){
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  template <typename T>
+  struct Block{
+    T a[blockSize], b[blockSize], c[blockSize], d[blockSize];
+
+    void load(const Mat2x2BatchView<const T> &view, size_t first, size_t count){
+      memcpy(a, view.a + first, count * sizeof(T));
+      memcpy(b, view.b + first, count * sizeof(T));
+      memcpy(c, view.c + first, count * sizeof(T));
+      memcpy(d, view.d + first, count * sizeof(T));
+    }
+  };
+
+  template <typename Acc, typename T>
+  void multiply(const Mat2x2BatchView<const T> &lhs, const Mat2x2BatchView<const T> &rhs, const Mat2x2BatchView<T> &out){
+    checkSizes(lhs, rhs);
+    checkSizes(lhs, out);
+    if(!overlaps(lhs, out) && !overlaps(rhs, out)){
+      multiplyKernel<Acc>(lhs.a, lhs.b, lhs.c, lhs.d, rhs.a, rhs.b, rhs.c, rhs.d, out.a, out.b, out.c, out.d, out.size);
+      return;
+    }
+    Block<T> l, r;
+    for(size_t first = 0; first < out.size; first += blockSize){
+      size_t count = min(blockSize, out.size - first);
+      l.load(lhs, first, count);
+      r.load(rhs, first, count);
+      multiplyKernel<Acc, T>(l.a, l.b, l.c, l.d, r.a, r.b, r.c, r.d, out.a + first, out.b + first, out.c + first, out.d + first, count);
+    }
+  }
+
+  template <typename Acc, typename T>
+  void determinant(const Mat2x2BatchView<const T> &in, T *out){
+    for(size_t i = 0; i < in.size; i++){
+      Acc a = in.a[i], b = in.b[i], c = in.c[i], d = in.d[i];
+      out[i] = (T) ((a * d) - (b * c));
+    }
+  }
+
+  template <typename Acc, typename T>
+  size_t inverse(const Mat2x2BatchView<const T> &in, const Mat2x2BatchView<T> &out){
+    checkSizes(in, out);
+    if(!overlaps(in, out)){
+      return inverseKernel<Acc>(in.a, in.b, in.c, in.d, out.a, out.b, out.c, out.d, out.size);
+    }
+    size_t singular = 0;
+    Block<T> m;
+    for(size_t first = 0; first < in.size; first += blockSize){
+      size_t count = min(blockSize, in.size - first);
+      m.load(in, first, count);
+      singular += inverseKernel<Acc, T>(m.a, m.b, m.c, m.d, out.a + first, out.b + first, out.c + first, out.d + first, count);
+    }
+    return singular;
+  }
+
+  // transpose only moves the arrays, b and c go through a block copy when they may overlap
+  template <typename T>
+  void transpose(const Mat2x2BatchView<const T> &in, const Mat2x2BatchView<T> &out){
+    checkSizes(in, out);
+    if(!overlaps(in, out)){
+      memcpy(out.a, in.a, in.size * sizeof(T));
+      memcpy(out.b, in.c, in.size * sizeof(T));
+      memcpy(out.c, in.b, in.size * sizeof(T));
+      memcpy(out.d, in.d, in.size * sizeof(T));
+      return;
+    }
+    Block<T> m;
+    for(size_t first = 0; first < in.size; first += blockSize){
+      size_t count = min(blockSize, in.size - first);
+      m.load(in, first, count);
+      memcpy(out.a + first, m.a, count * sizeof(T));
+      memcpy(out.b + first, m.c, count * sizeof(T));
+      memcpy(out.c + first, m.b, count * sizeof(T));
+      memcpy(out.d + first, m.d, count * sizeof(T));
+    }
+  }
+}
+
+//-----------------------------------------------
+/*
+* Following functions are the double and float versions of
+* the batch kernels, see Mat2x2Batch.h
+*/
+//-----------------------------------------------
+void batchMultiply(const Mat2x2BatchView<const double> &lhs, const Mat2x2BatchView<const double> &rhs, const Mat2x2BatchView<double> &out){
+  multiply<double>(lhs, rhs, out);
+}
+
+void batchMultiply(const Mat2x2BatchView<const float> &lhs, const Mat2x2BatchView<const float> &rhs, const Mat2x2BatchView<float> &out,
+                   Accumulate accumulate){
+  if(accumulate == Accumulate::Double){
+    multiply<double>(lhs, rhs, out);
+  }
+  else{
+    multiply<float>(lhs, rhs, out);
+  }
+}
+
+void batchDeterminant(const Mat2x2BatchView<const double> &in, double *out){
+  determinant<double>(in, out);
+}
+
+void batchDeterminant(const Mat2x2BatchView<const float> &in, float *out, Accumulate accumulate){
+  if(accumulate == Accumulate::Double){
+    determinant<double>(in, out);
+  }
+  else{
+    determinant<float>(in, out);
+  }
+}
+
+//-----------------------------------------------
+/*
+* Following functions are the compensated versions of the
+* determinant and the eigenvalue discriminant, with hardware
+* FMA they cost two and five more flops than the plain
+* determinant and still vectorize.
+*/
+//-----------------------------------------------
+void batchPreciseDeterminant(const Mat2x2BatchView<const double> &in, double *out){
+  for(size_t i = 0; i < in.size; i++){
+    out[i] = compensatedDeterminant(in.a[i], in.b[i], in.c[i], in.d[i]);
+  }
+}
+
+void batchDiscriminant(const Mat2x2BatchView<const double> &in, double *out){
+  for(size_t i = 0; i < in.size; i++){
+    out[i] = compensatedDiscriminant(in.a[i], in.b[i], in.c[i], in.d[i]);
+  }
+}
+
+size_t batchInverse(const Mat2x2BatchView<const double> &in, const Mat2x2BatchView<double> &out){
+  return inverse<double>(in, out);
+}
+
+size_t batchInverse(const Mat2x2BatchView<const float> &in, const Mat2x2BatchView<float> &out, Accumulate accumulate){
+  if(accumulate == Accumulate::Double){
+    return inverse<double>(in, out);
+  }
+  return inverse<float>(in, out);
+}
+
+void batchTranspose(const Mat2x2BatchView<const double> &in, const Mat2x2BatchView<double> &out){
+  transpose(in, out);
+}
+
+void batchTranspose(const Mat2x2BatchView<const float> &in, const Mat2x2BatchView<float> &out){
+  transpose(in, out);
+}
@@ -0,0 +1,287 @@
+//-----------------------------------------------
+/**
+* This is the implementation file for the conversions of tiles
+* of 4 doubles and 8 floats. Four interleaved matrices are a
+* 4x4 block of elements and a tile is the transpose of that
+* block, so each group of four matrices is loaded into
+* registers, transposed with unpack, shuffle and lane permute
+* instructions and stored, which keeps the conversion close to
+* the speed of a memcpy.
+*
+* Without AVX the same is done with SSE2 on pairs of double
+* matrices or on each half of a float tile, and without SSE2
+* with plain loops.
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+
+#include "Mat2x2Tiles.h"
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+  typedef Mat2x2Tile<double, 4> Tile;
+  typedef Mat2x2Tile<float, 8> FloatTile;
+
+  //-----------------------------------------------
+  /*
+  * This is a helper method which converts the whole tiles,
+  * the elements of a matrix are in the order first, second,
+  * third, fourth and RowMajor is a b c d, ColumnMajor a c b d.
+  */
+  //-----------------------------------------------
+  void toFullTiles(const double *src, size_t tileCount, bool rowMajor, Tile *tiles){
+    for(size_t t = 0; t < tileCount; t++, src += 16){
+      double *dst = tiles[t].a;
+#if defined(__AVX__)
+      __m256d r0 = _mm256_loadu_pd(src);
+      __m256d r1 = _mm256_loadu_pd(src + 4);
+      __m256d r2 = _mm256_loadu_pd(src + 8);
+      __m256d r3 = _mm256_loadu_pd(src + 12);
+      __m256d t0 = _mm256_unpacklo_pd(r0, r1); // first0 first1 third0 third1
+      __m256d t1 = _mm256_unpackhi_pd(r0, r1); // second0 second1 fourth0 fourth1
+      __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+      __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+      __m256d first = _mm256_permute2f128_pd(t0, t2, 0x20);
+      __m256d second = _mm256_permute2f128_pd(t1, t3, 0x20);
+      __m256d third = _mm256_permute2f128_pd(t0, t2, 0x31);
+      __m256d fourth = _mm256_permute2f128_pd(t1, t3, 0x31);
+      _mm256_storeu_pd(dst, first);
+      _mm256_storeu_pd(dst + (rowMajor ? 4 : 8), second);
+      _mm256_storeu_pd(dst + (rowMajor ? 8 : 4), third);
+      _mm256_storeu_pd(dst + 12, fourth);
+#elif defined(__SSE2__)
+      for(size_t pair = 0; pair < 4; pair += 2){
+        const double *mat = src + 4 * pair;
+        __m128d head0 = _mm_loadu_pd(mat); // first second of the matrix pair
+        __m128d tail0 = _mm_loadu_pd(mat + 2); // third fourth
+        __m128d head1 = _mm_loadu_pd(mat + 4);
+        __m128d tail1 = _mm_loadu_pd(mat + 6);
+        _mm_storeu_pd(dst + pair, _mm_unpacklo_pd(head0, head1));
+        _mm_storeu_pd(dst + (rowMajor ? 4 : 8) + pair, _mm_unpackhi_pd(head0, head1));
+        _mm_storeu_pd(dst + (rowMajor ? 8 : 4) + pair, _mm_unpacklo_pd(tail0, tail1));
+        _mm_storeu_pd(dst + 12 + pair, _mm_unpackhi_pd(tail0, tail1));
+      }
+#else
+      for(size_t j = 0; j < 4; j++){
+        dst[j] = src[4 * j];
+        dst[(rowMajor ? 4 : 8) + j] = src[4 * j + 1];
+        dst[(rowMajor ? 8 : 4) + j] = src[4 * j + 2];
+        dst[12 + j] = src[4 * j + 3];
+      }
+#endif
+    }
+  }
+
+  void fromFullTiles(const Tile *tiles, size_t tileCount, bool rowMajor, double *dst){
+    for(size_t t = 0; t < tileCount; t++, dst += 16){
+      const double *src = tiles[t].a;
+#if defined(__AVX__)
+      __m256d first = _mm256_loadu_pd(src);
+      __m256d second = _mm256_loadu_pd(src + (rowMajor ? 4 : 8));
+      __m256d third = _mm256_loadu_pd(src + (rowMajor ? 8 : 4));
+      __m256d fourth = _mm256_loadu_pd(src + 12);
+      __m256d t0 = _mm256_permute2f128_pd(first, third, 0x20); // first0 first1 third0 third1
+      __m256d t1 = _mm256_permute2f128_pd(second, fourth, 0x20);
+      __m256d t2 = _mm256_permute2f128_pd(first, third, 0x31);
+      __m256d t3 = _mm256_permute2f128_pd(second, fourth, 0x31);
+      _mm256_storeu_pd(dst, _mm256_unpacklo_pd(t0, t1));
+      _mm256_storeu_pd(dst + 4, _mm256_unpackhi_pd(t0, t1));
+      _mm256_storeu_pd(dst + 8, _mm256_unpacklo_pd(t2, t3));
+      _mm256_storeu_pd(dst + 12, _mm256_unpackhi_pd(t2, t3));
+#elif defined(__SSE2__)
+      for(size_t pair = 0; pair < 4; pair += 2){
+        __m128d first = _mm_loadu_pd(src + pair);
+        __m128d second = _mm_loadu_pd(src + (rowMajor ? 4 : 8) + pair);
+        __m128d third = _mm_loadu_pd(src + (rowMajor ? 8 : 4) + pair);
+        __m128d fourth = _mm_loadu_pd(src + 12 + pair);
+        double *mat = dst + 4 * pair;
+        _mm_storeu_pd(mat, _mm_unpacklo_pd(first, second));
+        _mm_storeu_pd(mat + 2, _mm_unpacklo_pd(third, fourth));
+        _mm_storeu_pd(mat + 4, _mm_unpackhi_pd(first, second));
+        _mm_storeu_pd(mat + 6, _mm_unpackhi_pd(third, fourth));
+      }
+#else
+      for(size_t j = 0; j < 4; j++){
+        dst[4 * j] = src[j];
+        dst[4 * j + 1] = src[(rowMajor ? 4 : 8) + j];
+        dst[4 * j + 2] = src[(rowMajor ? 8 : 4) + j];
+        dst[4 * j + 3] = src[12 + j];
+      }
+#endif
+    }
+  }
+
+  //-----------------------------------------------
+  /*
+  * Following functions convert whole tiles of 8 floats. With
+  * AVX matrices j and j + 4 are loaded into the two 128-bit
+  * lanes of one register, so the 4x4 transpose inside each
+  * lane leaves elements 0-3 of a tile array in the low lane
+  * and 4-7 in the high lane without a shuffle across lanes.
+  */
+  //-----------------------------------------------
+  void toFullTiles(const float *src, size_t tileCount, bool rowMajor, FloatTile *tiles){
+    for(size_t t = 0; t < tileCount; t++, src += 32){
+      float *dst = tiles[t].a;
+#if defined(__AVX__)
+      __m256 r0 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(src)), _mm_loadu_ps(src + 16), 1);
+      __m256 r1 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(src + 4)), _mm_loadu_ps(src + 20), 1);
+      __m256 r2 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(src + 8)), _mm_loadu_ps(src + 24), 1);
+      __m256 r3 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(src + 12)), _mm_loadu_ps(src + 28), 1);
+      __m256 t0 = _mm256_unpacklo_ps(r0, r1); // first0 first1 second0 second1, per lane
+      __m256 t1 = _mm256_unpackhi_ps(r0, r1); // third0 third1 fourth0 fourth1
+      __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+      __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+      _mm256_storeu_ps(dst, _mm256_shuffle_ps(t0, t2, 0x44));
+      _mm256_storeu_ps(dst + (rowMajor ? 8 : 16), _mm256_shuffle_ps(t0, t2, 0xee));
+      _mm256_storeu_ps(dst + (rowMajor ? 16 : 8), _mm256_shuffle_ps(t1, t3, 0x44));
+      _mm256_storeu_ps(dst + 24, _mm256_shuffle_ps(t1, t3, 0xee));
+#elif defined(__SSE2__)
+      for(size_t half = 0; half < 8; half += 4){
+        const float *mat = src + 4 * half;
+        __m128 t0 = _mm_unpacklo_ps(_mm_loadu_ps(mat), _mm_loadu_ps(mat + 4));
+        __m128 t1 = _mm_unpackhi_ps(_mm_loadu_ps(mat), _mm_loadu_ps(mat + 4));
+        __m128 t2 = _mm_unpacklo_ps(_mm_loadu_ps(mat + 8), _mm_loadu_ps(mat + 12));
+        __m128 t3 = _mm_unpackhi_ps(_mm_loadu_ps(mat + 8), _mm_loadu_ps(mat + 12));
+        _mm_storeu_ps(dst + half, _mm_shuffle_ps(t0, t2, 0x44));
+        _mm_storeu_ps(dst + (rowMajor ? 8 : 16) + half, _mm_shuffle_ps(t0, t2, 0xee));
+        _mm_storeu_ps(dst + (rowMajor ? 16 : 8) + half, _mm_shuffle_ps(t1, t3, 0x44));
+        _mm_storeu_ps(dst + 24 + half, _mm_shuffle_ps(t1, t3, 0xee));
+      }
+#else
+      for(size_t j = 0; j < 8; j++){
+        dst[j] = src[4 * j];
+        dst[(rowMajor ? 8 : 16) + j] = src[4 * j + 1];
+        dst[(rowMajor ? 16 : 8) + j] = src[4 * j + 2];
+        dst[24 + j] = src[4 * j + 3];
+      }
+#endif
+    }
+  }
+
+  void fromFullTiles(const FloatTile *tiles, size_t tileCount, bool rowMajor, float *dst){
+    for(size_t t = 0; t < tileCount; t++, dst += 32){
+      const float *src = tiles[t].a;
+#if defined(__AVX__)
+      __m256 first = _mm256_loadu_ps(src);
+      __m256 second = _mm256_loadu_ps(src + (rowMajor ? 8 : 16));
+      __m256 third = _mm256_loadu_ps(src + (rowMajor ? 16 : 8));
+      __m256 fourth = _mm256_loadu_ps(src + 24);
+      __m256 t0 = _mm256_unpacklo_ps(first, second); // first0 second0 first1 second1, per lane
+      __m256 t1 = _mm256_unpackhi_ps(first, second);
+      __m256 t2 = _mm256_unpacklo_ps(third, fourth);
+      __m256 t3 = _mm256_unpackhi_ps(third, fourth);
+      __m256 m0 = _mm256_shuffle_ps(t0, t2, 0x44); // matrix 0 in the low lane, 4 in the high one
+      __m256 m1 = _mm256_shuffle_ps(t0, t2, 0xee);
+      __m256 m2 = _mm256_shuffle_ps(t1, t3, 0x44);
+      __m256 m3 = _mm256_shuffle_ps(t1, t3, 0xee);
+      _mm_storeu_ps(dst, _mm256_castps256_ps128(m0));
+      _mm_storeu_ps(dst + 4, _mm256_castps256_ps128(m1));
+      _mm_storeu_ps(dst + 8, _mm256_castps256_ps128(m2));
+      _mm_storeu_ps(dst + 12, _mm256_castps256_ps128(m3));
+      _mm_storeu_ps(dst + 16, _mm256_extractf128_ps(m0, 1));
+      _mm_storeu_ps(dst + 20, _mm256_extractf128_ps(m1, 1));
+      _mm_storeu_ps(dst + 24, _mm256_extractf128_ps(m2, 1));
+      _mm_storeu_ps(dst + 28, _mm256_extractf128_ps(m3, 1));
+#elif defined(__SSE2__)
+      for(size_t half = 0; half < 8; half += 4){
+        __m128 first = _mm_loadu_ps(src + half);
+        __m128 second = _mm_loadu_ps(src + (rowMajor ? 8 : 16) + half);
+        __m128 third = _mm_loadu_ps(src + (rowMajor ? 16 : 8) + half);
+        __m128 fourth = _mm_loadu_ps(src + 24 + half);
+        __m128 t0 = _mm_unpacklo_ps(first, second);
+        __m128 t1 = _mm_unpackhi_ps(first, second);
+        __m128 t2 = _mm_unpacklo_ps(third, fourth);
+        __m128 t3 = _mm_unpackhi_ps(third, fourth);
+        float *mat = dst + 4 * half;
+        _mm_storeu_ps(mat, _mm_shuffle_ps(t0, t2, 0x44));
+        _mm_storeu_ps(mat + 4, _mm_shuffle_ps(t0, t2, 0xee));
+        _mm_storeu_ps(mat + 8, _mm_shuffle_ps(t1, t3, 0x44));
+        _mm_storeu_ps(mat + 12, _mm_shuffle_ps(t1, t3, 0xee));
+      }
+#else
+      for(size_t j = 0; j < 8; j++){
+        dst[4 * j] = src[j];
+        dst[4 * j + 1] = src[(rowMajor ? 8 : 16) + j];
+        dst[4 * j + 2] = src[(rowMajor ? 16 : 8) + j];
+        dst[4 * j + 3] = src[24 + j];
+      }
+#endif
+    }
+  }
+
+  // the last partial tile, zero past count
+  template <typename T, size_t W>
+  void toLastTile(const T *src, size_t rest, bool rowMajor, Mat2x2Tile<T, W> &tile){
+    for(size_t j = 0; j < W; j++){
+      const T *mat = src + 4 * (j < rest ? j : 0);
+      bool valid = j < rest;
+      tile.a[j] = valid ? mat[0] : T(0);
+      tile.b[j] = valid ? mat[rowMajor ? 1 : 2] : T(0);
+      tile.c[j] = valid ? mat[rowMajor ? 2 : 1] : T(0);
+      tile.d[j] = valid ? mat[3] : T(0);
+    }
+  }
+
+  template <typename T, size_t W>
+  void fromLastTile(const Mat2x2Tile<T, W> &tile, size_t rest, bool rowMajor, T *dst){
+    for(size_t j = 0; j < rest; j++){
+      T *mat = dst + 4 * j;
+      mat[0] = tile.a[j];
+      mat[rowMajor ? 1 : 2] = tile.b[j];
+      mat[rowMajor ? 2 : 1] = tile.c[j];
+      mat[3] = tile.d[j];
+    }
+  }
+}
+
+//-----------------------------------------------
+/*
+* Following functions are the tiles of 4 doubles and 8 floats
+* versions of toTiles and fromTiles, the whole tiles go
+* through the registers and the last partial tile through
+* plain loops.
+*/
+//-----------------------------------------------
+template <>
+void toTiles<double, 4>(const double *src, size_t count, ElementOrder order, Tile *tiles){
+  size_t full = count / 4;
+  toFullTiles(src, full, order == ElementOrder::RowMajor, tiles);
+  if(count > 4 * full){
+    toLastTile(src + 16 * full, count - 4 * full, order == ElementOrder::RowMajor, tiles[full]);
+  }
+}
+
+template <>
+void fromTiles<double, 4>(const Tile *tiles, size_t count, ElementOrder order, double *dst){
+  size_t full = count / 4;
+  fromFullTiles(tiles, full, order == ElementOrder::RowMajor, dst);
+  if(count > 4 * full){
+    fromLastTile(tiles[full], count - 4 * full, order == ElementOrder::RowMajor, dst + 16 * full);
+  }
+}
+
+template <>
+void toTiles<float, 8>(const float *src, size_t count, ElementOrder order, FloatTile *tiles){
+  size_t full = count / 8;
+  toFullTiles(src, full, order == ElementOrder::RowMajor, tiles);
+  if(count > 8 * full){
+    toLastTile(src + 32 * full, count - 8 * full, order == ElementOrder::RowMajor, tiles[full]);
+  }
+}
+
+template <>
+void fromTiles<float, 8>(const FloatTile *tiles, size_t count, ElementOrder order, float *dst){
+  size_t full = count / 8;
+  fromFullTiles(tiles, full, order == ElementOrder::RowMajor, dst);
+  if(count > 8 * full){
+    fromLastTile(tiles[full], count - 8 * full, order == ElementOrder::RowMajor, dst + 32 * full);
+  }
+}
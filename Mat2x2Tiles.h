@@ -0,0 +1,263 @@
+//-----------------------------------------------
+/**
+* This is the header file for the tiled (array of structures
+* of arrays) layout of Mat2x2 collections and the kernels which
+* convert it to and from the other layouts.
+*
+* A Mat2x2Tile holds W matrices as four arrays of W elements,
+* so a tile of 4 doubles or 8 floats fills one SIMD register
+* per element while the tiles themselves are contiguous like
+* an array of Mat2x2 objects.
+*
+* The layouts which can be converted are
+*
+* RowMajor     a0 b0 c0 d0 a1 b1 c1 d1 ...  i.e std::vector<Mat2x2>
+* ColumnMajor  a0 c0 b0 d0 a1 c1 b1 d1 ...
+* SoA          a0 a1 ... / b0 b1 ... / c0 c1 ... / d0 d1 ...  i.e Mat2x2BatchView
+*
+* The elements of the last tile past count are zero. Tiles of
+* 4 doubles and of 8 floats are converted with in-register
+* transposes (AVX, or SSE2 on halves of a tile), every other
+* tile shape uses the generic loops.
+*
+* Cost of the conversions of interleaved matrices, measured
+* with "tiles" in bench/bench.cpp built with g++ -O3
+* -march=native on an AVX-512 Xeon, in ns per matrix and
+* against a memcpy of the same bytes:
+*
+* tile        matrices  order   memcpy  toTiles      fromTiles
+* ----------  --------  ------  ------  -----------  -----------
+* double x 4  2^12      row     1.06    1.68, 1.6x   2.98, 2.8x
+* double x 4  2^12      column  1.06    2.83, 2.7x   2.83, 2.7x
+* double x 4  2^20      row     7.42    7.67, 1.0x   11.26, 1.5x
+* double x 4  2^20      column  7.42    10.78, 1.5x  10.43, 1.4x
+* float x 8   2^12      row     0.77    0.81, 1.1x   0.79, 1.0x
+* float x 8   2^12      column  0.77    1.51, 2.0x   0.80, 1.0x
+* float x 8   2^20      row     3.58    3.46, 1.0x   3.70, 1.0x
+* float x 8   2^20      column  3.58    4.89, 1.4x   3.43, 1.0x
+*
+* Out of the cache the conversions run at 1.0x to 1.5x the
+* time of memcpy, in the L2 cache the double ones take up to
+* 2.8x, the shuffles rather than memory being the limit there.
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+#ifndef MAT2X2TILES_H
+#define MAT2X2TILES_H
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "Mat2x2.h"
+#include "Mat2x2Batch.h"
+
+template <typename T, size_t W>
+struct Mat2x2Tile{
+  T a[W];
+  T b[W];
+  T c[W];
+  T d[W];
+};
+
+enum class ElementOrder{
+  RowMajor, // a, b, c, d per matrix, the layout of Mat2x2 itself
+  ColumnMajor // a, c, b, d per matrix
+};
+
+//-----------------------------------------------
+/*
+* Following functions convert count matrices between an
+* interleaved buffer of 4 * count elements and
+* (count + W - 1) / W tiles.
+*/
+//-----------------------------------------------
+template <typename T, size_t W>
+void toTiles(const T *src, size_t count, ElementOrder order, Mat2x2Tile<T, W> *tiles){
+  size_t second = order == ElementOrder::RowMajor ? 1 : 2; // offset of b
+  size_t third = 3 - second; // offset of c
+  size_t tileCount = (count + W - 1) / W;
+  for(size_t t = 0; t < tileCount; t++){
+    Mat2x2Tile<T, W> &tile = tiles[t];
+    for(size_t j = 0; j < W; j++){
+      size_t i = t * W + j;
+      bool valid = i < count;
+      const T *mat = src + 4 * (valid ? i : 0);
+      tile.a[j] = valid ? mat[0] : T(0);
+      tile.b[j] = valid ? mat[second] : T(0);
+      tile.c[j] = valid ? mat[third] : T(0);
+      tile.d[j] = valid ? mat[3] : T(0);
+    }
+  }
+}
+
+template <typename T, size_t W>
+void fromTiles(const Mat2x2Tile<T, W> *tiles, size_t count, ElementOrder order, T *dst){
+  size_t second = order == ElementOrder::RowMajor ? 1 : 2;
+  size_t third = 3 - second;
+  for(size_t i = 0; i < count; i++){
+    const Mat2x2Tile<T, W> &tile = tiles[i / W];
+    T *mat = dst + 4 * i;
+    mat[0] = tile.a[i % W];
+    mat[second] = tile.b[i % W];
+    mat[third] = tile.c[i % W];
+    mat[3] = tile.d[i % W];
+  }
+}
+
+// in-register transposes for tiles of 4 doubles and 8 floats, see Mat2x2Tiles.cpp
+template <>
+void toTiles<double, 4>(const double *src, size_t count, ElementOrder order, Mat2x2Tile<double, 4> *tiles);
+template <>
+void fromTiles<double, 4>(const Mat2x2Tile<double, 4> *tiles, size_t count, ElementOrder order, double *dst);
+template <>
+void toTiles<float, 8>(const float *src, size_t count, ElementOrder order, Mat2x2Tile<float, 8> *tiles);
+template <>
+void fromTiles<float, 8>(const Mat2x2Tile<float, 8> *tiles, size_t count, ElementOrder order, float *dst);
+
+//-----------------------------------------------
+/*
+* Following functions convert between an array of Mat2x2
+* objects and tiles. The matrices are copied with
+* getElements() and setElements() through a row-major buffer
+* of about 64 matrices on the stack, so whole tiles still go
+* through the register transposes. Float tiles round the
+* elements to float.
+*/
+//-----------------------------------------------
+template <typename T, size_t W>
+void toTiles(const Mat2x2 *mats, size_t count, Mat2x2Tile<T, W> *tiles){
+  const size_t chunkTiles = (64 + W - 1) / W;
+  T buffer[4 * chunkTiles * W];
+  for(size_t first = 0; first < count; first += chunkTiles * W){
+    size_t n = count - first < chunkTiles * W ? count - first : chunkTiles * W;
+    for(size_t i = 0; i < n; i++){
+      double elements[4];
+      mats[first + i].getElements(elements);
+      for(int j = 0; j < 4; j++){
+        buffer[4 * i + j] = (T) elements[j];
+      }
+    }
+    toTiles(buffer, n, ElementOrder::RowMajor, tiles + first / W);
+  }
+}
+
+template <typename T, size_t W>
+void fromTiles(const Mat2x2Tile<T, W> *tiles, size_t count, Mat2x2 *mats){
+  const size_t chunkTiles = (64 + W - 1) / W;
+  T buffer[4 * chunkTiles * W];
+  for(size_t first = 0; first < count; first += chunkTiles * W){
+    size_t n = count - first < chunkTiles * W ? count - first : chunkTiles * W;
+    fromTiles(tiles + first / W, n, ElementOrder::RowMajor, buffer);
+    for(size_t i = 0; i < n; i++){
+      double elements[4] = {buffer[4 * i], buffer[4 * i + 1], buffer[4 * i + 2], buffer[4 * i + 3]};
+      mats[first + i].setElements(elements);
+    }
+  }
+}
+
+//-----------------------------------------------
+/*
+* Following functions convert between a SoA view and tiles,
+* every tile is four copies of W contiguous elements.
+*/
+//-----------------------------------------------
+template <typename T, typename U, size_t W>
+void toTiles(const Mat2x2BatchView<U> &soa, Mat2x2Tile<T, W> *tiles){
+  static_assert(std::is_same<typename std::remove_const<U>::type, T>::value, "the view and the tiles must have the same element type");
+  size_t tileCount = (soa.size + W - 1) / W;
+  for(size_t t = 0; t < tileCount; t++){
+    size_t first = t * W;
+    size_t n = soa.size - first < W ? soa.size - first : W;
+    if(n < W){
+      memset(&tiles[t], 0, sizeof(tiles[t]));
+    }
+    memcpy(tiles[t].a, soa.a + first, n * sizeof(T));
+    memcpy(tiles[t].b, soa.b + first, n * sizeof(T));
+    memcpy(tiles[t].c, soa.c + first, n * sizeof(T));
+    memcpy(tiles[t].d, soa.d + first, n * sizeof(T));
+  }
+}
+
+template <typename T, size_t W>
+void fromTiles(const Mat2x2Tile<T, W> *tiles, const Mat2x2BatchView<T> &soa){
+  size_t tileCount = (soa.size + W - 1) / W;
+  for(size_t t = 0; t < tileCount; t++){
+    size_t first = t * W;
+    size_t n = soa.size - first < W ? soa.size - first : W;
+    memcpy(soa.a + first, tiles[t].a, n * sizeof(T));
+    memcpy(soa.b + first, tiles[t].b, n * sizeof(T));
+    memcpy(soa.c + first, tiles[t].c, n * sizeof(T));
+    memcpy(soa.d + first, tiles[t].d, n * sizeof(T));
+  }
+}
+
+//-----------------------------------------------
+/*
+* Mat2x2Tiles class owns the tiles of a collection of
+* matrices, i.e Mat2x2Tiles<double, 4> tiles(mats);
+*/
+//-----------------------------------------------
+template <typename T, size_t W>
+class Mat2x2Tiles{
+  static_assert(W > 0, "a tile holds at least one matrix");
+  private:
+    std::vector<Mat2x2Tile<T, W> > tiles;
+    size_t count;
+  public:
+    explicit Mat2x2Tiles(size_t size = 0) : tiles((size + W - 1) / W), count(size) {
+      if(!tiles.empty()){
+        memset(tiles.data(), 0, tiles.size() * sizeof(tiles[0]));
+      }
+    }
+    explicit Mat2x2Tiles(const std::vector<Mat2x2> &mats) : tiles((mats.size() + W - 1) / W), count(mats.size()) {
+      toTiles(mats.data(), count, tiles.data());
+    }
+
+    size_t size() const{
+      return count;
+    }
+
+    size_t tileCount() const{
+      return tiles.size();
+    }
+
+    Mat2x2Tile<T, W> *data(){
+      return tiles.data();
+    }
+
+    const Mat2x2Tile<T, W> *data() const{
+      return tiles.data();
+    }
+
+    Mat2x2 get(size_t i) const{
+      if(i >= count){
+        throw std::invalid_argument("invalid argument");
+      }
+      const Mat2x2Tile<T, W> &tile = tiles[i / W];
+      return Mat2x2(tile.a[i % W], tile.b[i % W], tile.c[i % W], tile.d[i % W]);
+    }
+
+    void set(size_t i, const Mat2x2 &mat){
+      if(i >= count){
+        throw std::invalid_argument("invalid argument");
+      }
+      double elements[4];
+      mat.getElements(elements);
+      Mat2x2Tile<T, W> &tile = tiles[i / W];
+      tile.a[i % W] = (T) elements[0];
+      tile.b[i % W] = (T) elements[1];
+      tile.c[i % W] = (T) elements[2];
+      tile.d[i % W] = (T) elements[3];
+    }
+
+    std::vector<Mat2x2> toMatrices() const{
+      std::vector<Mat2x2> mats(count);
+      fromTiles(tiles.data(), count, mats.data());
+      return mats;
+    }
+};
+#endif
@@ -0,0 +1,58 @@
+//-----------------------------------------------
+/**
+* This is the implementation file for the cache keys and
+* statistics of Mat2x2MemoCache class.
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+
+#include <cstring>
+#include "MemoCache.h"
+
+using namespace std;
+
+//-----------------------------------------------
+/*
+* Constructor for the key which copies the bits of the
+* a, b, c and d elements of the matrix.
+*/
+//-----------------------------------------------
+Mat2x2Key::Mat2x2Key(const Mat2x2 &mat){
+  for(int i = 0; i < 4; i++){
+    double value = mat[i];
+    memcpy(&bits[i], &value, sizeof(value));
+  }
+}
+
+bool Mat2x2Key::operator==(const Mat2x2Key &key) const{
+  return bits[0] == key.bits[0] && bits[1] == key.bits[1] && bits[2] == key.bits[2] && bits[3] == key.bits[3];
+}
+
+//-----------------------------------------------
+/*
+* This function multiplies every word of the key by its own
+* odd constant and mixes the sum with the splitmix64
+* finalizer, so matrices which differ only in the low bits
+* of one element, or only in the order of the elements,
+* land in different sets. The four products are independent
+* so a lookup doesn't wait on a chain of mixing rounds.
+*/
+//-----------------------------------------------
+size_t Mat2x2Key::hash() const{
+  uint64_t h = (bits[0] * 0x9e3779b97f4a7c15ULL) + (bits[1] * 0xc2b2ae3d27d4eb4fULL)
+               + (bits[2] * 0x165667b19e3779f9ULL) + (bits[3] * 0xd6e8feb86659fd93ULL);
+  h ^= h >> 30;
+  h *= 0xbf58476d1ce4e5b9ULL;
+  h ^= h >> 27;
+  h *= 0x94d049bb133111ebULL;
+  h ^= h >> 31;
+  return (size_t) h;
+}
+
+double CacheStats::hitRate() const{
+  uint64_t lookups = hits + misses;
+  return lookups == 0 ? 0 : (double) hits / lookups;
+}
@@ -0,0 +1,167 @@
+//-----------------------------------------------
+/**
+* This is the implementation file for the Mobius transformation
+* functions. Every chunk of points first goes through a
+* branch-free loop and the few points which are infinite, hit
+* a pole or overflow are evaluated again with the exact rules
+* of applyMobius(mat, z).
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include "Mobius.h"
+#include "Parallel.h"
+
+using namespace std;
+
+namespace {
+  const size_t pointsPerTask = 8192;
+
+  complex<double> infinity(){
+    return complex<double>(numeric_limits<double>::infinity(), numeric_limits<double>::infinity());
+  }
+
+  complex<double> notANumber(){
+    return complex<double>(numeric_limits<double>::quiet_NaN(), numeric_limits<double>::quiet_NaN());
+  }
+
+  //-----------------------------------------------
+  /*
+  * This is a helper method which evaluates count points with
+  *
+  * w = (a z + b) * conj(c z + d) / |c z + d|^2
+  *
+  * on the interleaved real and imaginary parts, and then fixes
+  * the points where that formula isn't valid. The points go
+  * through a small local block, so the fixes can still read
+  * the input when out is the same array as in.
+  */
+  //-----------------------------------------------
+  void applyRange(const Mat2x2 &mat, const complex<double> *in, complex<double> *out, size_t count){
+    const size_t blockSize = 256;
+    double m[4];
+    mat.getElements(m);
+    double a = m[0], b = m[1], c = m[2], d = m[3];
+    double block[2 * blockSize];
+    for(size_t first = 0; first < count; first += blockSize){
+      size_t n = count - first < blockSize ? count - first : blockSize;
+      const double *src = reinterpret_cast<const double *>(in + first);
+      size_t special = 0;
+      for(size_t i = 0; i < n; i++){
+        double x = src[2 * i], y = src[2 * i + 1];
+        double numReal = (a * x) + b, numImag = a * y;
+        double denReal = (c * x) + d, denImag = c * y;
+        double scale = 1 / ((denReal * denReal) + (denImag * denImag));
+        double real = ((numReal * denReal) + (numImag * denImag)) * scale;
+        double imag = ((numImag * denReal) - (numReal * denImag)) * scale;
+        block[2 * i] = real;
+        block[2 * i + 1] = imag;
+        special += !(std::isfinite(real) && std::isfinite(imag) && std::isfinite(scale) && scale != 0);
+      }
+      for(size_t i = 0; special > 0 && i < n; i++){
+        double x = src[2 * i], y = src[2 * i + 1];
+        double denReal = (c * x) + d, denImag = c * y;
+        double scale = 1 / ((denReal * denReal) + (denImag * denImag));
+        if(!(std::isfinite(block[2 * i]) && std::isfinite(block[2 * i + 1]) && std::isfinite(scale) && scale != 0)){
+          complex<double> w = applyMobius(mat, in[first + i]);
+          block[2 * i] = w.real();
+          block[2 * i + 1] = w.imag();
+        }
+      }
+      memcpy(out + first, block, n * sizeof(complex<double>));
+    }
+  }
+}
+
+//-----------------------------------------------
+/*
+* This function checks if a complex number is the point at
+* infinity, i.e either of its parts is infinite.
+*/
+//-----------------------------------------------
+bool isComplexInfinity(const complex<double> &z){
+  return std::isinf(z.real()) || std::isinf(z.imag());
+}
+
+//-----------------------------------------------
+/*
+* This function applies the transformation to one point. The
+* point at infinity is returned as (inf, inf).
+*/
+//-----------------------------------------------
+complex<double> applyMobius(const Mat2x2 &mat, const complex<double> &z){
+  double a = mat[0], b = mat[1], c = mat[2], d = mat[3];
+  if(isComplexInfinity(z)){
+    if(c != 0){
+      return complex<double>(a / c, 0);
+    }
+    if(a != 0){
+      return infinity();
+    }
+    return d != 0 ? complex<double>(b / d, 0) : notANumber();
+  }
+  complex<double> numerator = (a * z) + b;
+  complex<double> denominator = (c * z) + d;
+  if(denominator == 0.0){
+    return numerator == 0.0 ? notANumber() : infinity();
+  }
+  return numerator / denominator;
+}
+
+//-----------------------------------------------
+/*
+* Following functions apply the transformation to an array
+* of points, using the ThreadPool for large arrays.
+*/
+//-----------------------------------------------
+void applyMobius(const Mat2x2 &mat, const complex<double> *in, complex<double> *out, size_t count){
+  size_t tasks = (count + pointsPerTask - 1) / pointsPerTask;
+  parallelFor(ThreadPool::instance(), 0, tasks, 1, [&](size_t task){
+    size_t first = task * pointsPerTask;
+    size_t n = count - first < pointsPerTask ? count - first : pointsPerTask;
+    applyRange(mat, in + first, out + first, n);
+  });
+}
+
+vector<complex<double> > applyMobius(const Mat2x2 &mat, const vector<complex<double> > &points){
+  vector<complex<double> > temp(points.size());
+  applyMobius(mat, points.data(), temp.data(), points.size());
+  return temp;
+}
+
+//-----------------------------------------------
+/*
+* This function returns the single transformation which is the
+* same as applying chain[0], then chain[1] and so on, i.e
+* chain[n-1] * ... * chain[1] * chain[0]. An empty chain is
+* the identity.
+*/
+//-----------------------------------------------
+Mat2x2 composeMobius(const vector<Mat2x2> &chain){
+  Mat2x2 temp(1, 0, 0, 1);
+  for(size_t i = 0; i < chain.size(); i++){
+    temp = chain[i] * temp;
+  }
+  return temp;
+}
+
+//-----------------------------------------------
+/*
+* Following functions apply a chain of transformations to an
+* array of points, the chain is composed once so every point
+* costs a single evaluation.
+*/
+//-----------------------------------------------
+void applyMobius(const vector<Mat2x2> &chain, const complex<double> *in, complex<double> *out, size_t count){
+  applyMobius(composeMobius(chain), in, out, count);
+}
+
+vector<complex<double> > applyMobius(const vector<Mat2x2> &chain, const vector<complex<double> > &points){
+  return applyMobius(composeMobius(chain), points);
+}
@@ -0,0 +1,48 @@
+//-----------------------------------------------
+/**
+* This is the header file for the evaluation of Mat2x2 objects
+* as Mobius (linear fractional) transformations
+*
+*         a z + b
+* z ->  ---------
+*         c z + d
+*
+* over arrays of complex points. The composition of two such
+* transformations is the product of their matrices, i.e
+* applying m1 and then m2 is the same as applying m2 * m1.
+*
+* The point at infinity is any complex number with an infinite
+* part. A pole, c z + d = 0, is mapped to infinity and infinity
+* is mapped to a / c, or to infinity when c is 0. A singular
+* matrix, which isn't a Mobius transformation, gives NaN for
+* the points where both a z + b and c z + d are zero.
+*
+* The arrays are split over the ThreadPool and every chunk is
+* evaluated with real arithmetic on the interleaved parts, so
+* the common case is a branch-free loop which can be vectorized.
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+#ifndef MOBIUS_H
+#define MOBIUS_H
+#include <complex>
+#include <cstddef>
+#include <vector>
+#include "Mat2x2.h"
+
+bool isComplexInfinity(const std::complex<double> &z);
+
+std::complex<double> applyMobius(const Mat2x2 &mat, const std::complex<double> &z);
+
+// out[i] = mat applied to in[i], in and out may be the same array
+void applyMobius(const Mat2x2 &mat, const std::complex<double> *in, std::complex<double> *out, size_t count);
+std::vector<std::complex<double> > applyMobius(const Mat2x2 &mat, const std::vector<std::complex<double> > &points);
+
+// applies chain[0], then chain[1], ... by composing the chain once and evaluating the product
+Mat2x2 composeMobius(const std::vector<Mat2x2> &chain);
+void applyMobius(const std::vector<Mat2x2> &chain, const std::complex<double> *in, std::complex<double> *out, size_t count);
+std::vector<std::complex<double> > applyMobius(const std::vector<Mat2x2> &chain, const std::vector<std::complex<double> > &points);
+#endif
@@ -0,0 +1,168 @@
+//-----------------------------------------------
+/**
+* This is the header file for the parallel algorithms which
+* run on a ThreadPool. It describes parallelFor over an index
+* range and parallelTransform and parallelReduce over
+* collections of Mat2x2 objects.
+*
+* Every function splits its range into chunks of "grain"
+* elements, if 0 is passed as the grain then the range is
+* split into about 4 chunks per worker. The calling thread
+* runs chunks too while it waits, so the functions can be
+* nested. The first exception thrown by a chunk is rethrown
+* to the caller once every chunk has finished.
+*
+* The overloads without a pool argument use ThreadPool::instance()
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+#ifndef PARALLEL_H
+#define PARALLEL_H
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Mat2x2.h"
+#include "ThreadPool.h"
+
+//-----------------------------------------------
+/*
+* This function calls fn(i) for every i in [begin, end)
+* using the workers of the pool.
+*/
+//-----------------------------------------------
+template <typename Function>
+void parallelFor(ThreadPool &pool, size_t begin, size_t end, size_t grain, Function fn){
+  if(end <= begin){
+    return;
+  }
+  size_t count = end - begin;
+  if(grain == 0){
+    grain = std::max<size_t>(1, count / (pool.size() * 4));
+  }
+  size_t chunks = (count + grain - 1) / grain;
+  if(chunks == 1){
+    for(size_t i = begin; i < end; i++){
+      fn(i);
+    }
+    return;
+  }
+
+  std::atomic<size_t> remaining(chunks);
+  std::exception_ptr error;
+  std::mutex errorLock;
+  auto runChunk = [&](size_t chunk){
+    try{
+      size_t first = begin + chunk * grain;
+      size_t last = std::min(end, first + grain);
+      for(size_t i = first; i < last; i++){
+        fn(i);
+      }
+    }
+    catch(...){
+      std::lock_guard<std::mutex> guard(errorLock);
+      if(!error){
+        error = std::current_exception();
+      }
+    }
+    remaining.fetch_sub(1, std::memory_order_acq_rel);
+  };
+  for(size_t chunk = 1; chunk < chunks; chunk++){
+    pool.submit([&runChunk, chunk]{ runChunk(chunk); });
+  }
+  runChunk(0);
+  while(remaining.load(std::memory_order_acquire) != 0){
+    if(!pool.runPendingTask()){
+      std::this_thread::yield();
+    }
+  }
+  if(error){
+    std::rethrow_exception(error);
+  }
+}
+
+template <typename Function>
+void parallelFor(size_t begin, size_t end, Function fn){
+  parallelFor(ThreadPool::instance(), begin, end, 0, fn);
+}
+
+//-----------------------------------------------
+/*
+* This function writes fn(in[i]) to out[i] for every
+* matrix of the input, out is resized to the size of in.
+*/
+//-----------------------------------------------
+template <typename Function>
+void parallelTransform(ThreadPool &pool, const std::vector<Mat2x2> &in, std::vector<Mat2x2> &out, size_t grain, Function fn){
+  out.resize(in.size());
+  parallelFor(pool, 0, in.size(), grain, [&](size_t i){
+    out[i] = fn(in[i]);
+  });
+}
+
+template <typename Function>
+void parallelTransform(const std::vector<Mat2x2> &in, std::vector<Mat2x2> &out, Function fn){
+  parallelTransform(ThreadPool::instance(), in, out, 0, fn);
+}
+
+//-----------------------------------------------
+/*
+* This function folds map(i) for every i in [begin, end)
+* with combine, starting from identity.
+*
+* The partial results of the chunks are combined in the
+* order of the range, so combine only has to be associative,
+* i.e a Mat2x2 product, and doesn't have to be commutative.
+*/
+//-----------------------------------------------
+template <typename T, typename Map, typename Combine>
+T parallelReduce(ThreadPool &pool, size_t begin, size_t end, size_t grain, const T &identity, Map map, Combine combine){
+  if(end <= begin){
+    return identity;
+  }
+  size_t count = end - begin;
+  if(grain == 0){
+    grain = std::max<size_t>(1, count / (pool.size() * 4));
+  }
+  size_t chunks = (count + grain - 1) / grain;
+  std::vector<T> partials(chunks, identity);
+  parallelFor(pool, 0, chunks, 1, [&](size_t chunk){
+    size_t first = begin + chunk * grain;
+    size_t last = std::min(end, first + grain);
+    T partial = identity;
+    for(size_t i = first; i < last; i++){
+      partial = combine(partial, map(i));
+    }
+    partials[chunk] = partial;
+  });
+  T result = identity;
+  for(size_t chunk = 0; chunk < chunks; chunk++){
+    result = combine(result, partials[chunk]);
+  }
+  return result;
+}
+
+//-----------------------------------------------
+/*
+* This function folds every matrix of mats with combine,
+* i.e the product of the whole collection is
+*
+* parallelReduce(mats, Mat2x2(1, 0, 0, 1), std::multiplies<Mat2x2>())
+*/
+//-----------------------------------------------
+template <typename Combine>
+Mat2x2 parallelReduce(ThreadPool &pool, const std::vector<Mat2x2> &mats, size_t grain, const Mat2x2 &identity, Combine combine){
+  return parallelReduce(pool, 0, mats.size(), grain, identity, [&mats](size_t i){ return mats[i]; }, combine);
+}
+
+template <typename Combine>
+Mat2x2 parallelReduce(const std::vector<Mat2x2> &mats, const Mat2x2 &identity, Combine combine){
+  return parallelReduce(ThreadPool::instance(), mats, 0, identity, combine);
+}
+#endif
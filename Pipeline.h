@@ -0,0 +1,129 @@
+//-----------------------------------------------
+/**
+* This is the header file for PipelineStage class, which
+* connects two ring buffers from RingBuffer.h with one or
+* more threads. Every thread pops a block of matrices from
+* the input, applies the function of the stage to each of
+* them and pushes the block to the output, so a chain of
+* stages, i.e parse -> inverse() -> transpose() -> print, moves
+* Mat2x2 blocks between threads without any locks.
+*
+* Once the input is closed and drained the stage closes its
+* output, so closing the first buffer shuts down the whole
+* chain. If the function throws, i.e inverse() of a singular
+* matrix, the stage keeps draining its input without pushing
+* anything so the producers never get stuck, and join()
+* rethrows the first exception.
+*
+* A stage with more than one thread needs MpmcRingBuffer on both
+* sides, otherwise it throws invalid_argument error, and it
+* doesn't keep the order of the blocks.
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+#ifndef PIPELINE_H
+#define PIPELINE_H
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "Mat2x2.h"
+#include "RingBuffer.h"
+
+template <typename Input, typename Output>
+class PipelineStage{
+  private:
+    Input &in;
+    Output &out;
+    std::function<Mat2x2(const Mat2x2 &)> fn;
+    size_t blockSize;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> running;
+    std::exception_ptr error;
+    std::mutex errorLock;
+    std::atomic<bool> failed;
+
+    void run(){
+      std::vector<Mat2x2> block(blockSize);
+      while(true){
+        bool closed = in.isClosed();
+        size_t count = in.popBatch(block.data(), blockSize);
+        if(count == 0){
+          if(closed){
+            break;
+          }
+          std::this_thread::yield();
+          continue;
+        }
+        if(failed.load(std::memory_order_relaxed)){
+          continue;
+        }
+        try{
+          for(size_t i = 0; i < count; i++){
+            block[i] = fn(block[i]);
+          }
+        }
+        catch(...){
+          std::lock_guard<std::mutex> guard(errorLock);
+          if(!error){
+            error = std::current_exception();
+          }
+          failed.store(true, std::memory_order_relaxed);
+          continue;
+        }
+        size_t pushed = 0;
+        while(pushed < count){
+          size_t n = out.pushBatch(block.data() + pushed, count - pushed);
+          if(n == 0){
+            std::this_thread::yield();
+          }
+          pushed += n;
+        }
+      }
+      if(running.fetch_sub(1, std::memory_order_acq_rel) == 1){
+        out.close();
+      }
+    }
+
+  public:
+    PipelineStage(Input &input, Output &output, std::function<Mat2x2(const Mat2x2 &)> function,
+                  size_t block = 64, size_t threadCount = 1)
+      : in(input), out(output), fn(function), blockSize(block), running(threadCount), failed(false) {
+      if(blockSize == 0 || threadCount == 0 || (threadCount > 1 && !(Input::multiThreaded && Output::multiThreaded))){
+        throw std::invalid_argument("invalid argument");
+      }
+      for(size_t i = 0; i < threadCount; i++){
+        threads.push_back(std::thread(&PipelineStage::run, this));
+      }
+    }
+    PipelineStage(const PipelineStage &stage)=delete;
+    PipelineStage &operator=(const PipelineStage &stage)=delete;
+
+    ~PipelineStage(){
+      for(size_t i = 0; i < threads.size(); i++){
+        if(threads[i].joinable()){
+          threads[i].join();
+        }
+      }
+    }
+
+    // waits until the input is closed and drained
+    void join(){
+      for(size_t i = 0; i < threads.size(); i++){
+        if(threads[i].joinable()){
+          threads[i].join();
+        }
+      }
+      if(error){
+        std::rethrow_exception(error);
+      }
+    }
+};
+#endif
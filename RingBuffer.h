@@ -0,0 +1,231 @@
+//-----------------------------------------------
+/**
+* This is the header file for the bounded lock-free ring
+* buffers which move trivially copyable objects, i.e Mat2x2,
+* between threads.
+*
+* SpscRingBuffer allows one producer and one consumer thread,
+* MpmcRingBuffer allows any number of both. Both of them take
+* a capacity which is rounded up to a power of two, offer
+* single and batch push/pop operations which never block, and
+* a close() flag which the producer sets once it is done so
+* the consumer can tell an empty buffer from a finished one.
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+namespace ringbuffer {
+  const size_t cacheLine = 64;
+
+  // returns the smallest power of two which is not less than x
+  inline size_t roundUpPow2(size_t x){
+    if(x == 0){
+      throw std::invalid_argument("invalid argument");
+    }
+    size_t size = 1;
+    while(size < x){
+      size <<= 1;
+    }
+    return size;
+  }
+}
+
+//-----------------------------------------------
+/*
+* Single producer, single consumer ring buffer. The producer
+* only writes tail and the consumer only writes head, and each
+* side keeps a cached copy of the other side's index so that
+* it only touches the shared cache line when it looks full
+* or empty.
+*/
+//-----------------------------------------------
+template <typename T>
+class SpscRingBuffer{
+  static_assert(std::is_trivially_copyable<T>::value, "ring buffer elements must be trivially copyable");
+  private:
+    const size_t mask;
+    std::unique_ptr<T[]> slots;
+    alignas(ringbuffer::cacheLine) std::atomic<size_t> head; // next slot to read
+    size_t cachedTail;
+    alignas(ringbuffer::cacheLine) std::atomic<size_t> tail; // next slot to write
+    size_t cachedHead;
+    alignas(ringbuffer::cacheLine) std::atomic<bool> closed;
+  public:
+    static const bool multiThreaded = false;
+
+    explicit SpscRingBuffer(size_t capacity) : mask(ringbuffer::roundUpPow2(capacity) - 1),
+      slots(new T[mask + 1]), head(0), cachedTail(0), tail(0), cachedHead(0), closed(false) {}
+    SpscRingBuffer(const SpscRingBuffer &ring)=delete;
+    SpscRingBuffer &operator=(const SpscRingBuffer &ring)=delete;
+
+    size_t capacity() const{
+      return mask + 1;
+    }
+
+    // pushes up to count items and returns how many were pushed
+    size_t pushBatch(const T *items, size_t count){
+      size_t t = tail.load(std::memory_order_relaxed);
+      if(capacity() - (t - cachedHead) < count){
+        cachedHead = head.load(std::memory_order_acquire);
+      }
+      size_t free = capacity() - (t - cachedHead);
+      size_t n = count < free ? count : free;
+      for(size_t i = 0; i < n; i++){
+        slots[(t + i) & mask] = items[i];
+      }
+      tail.store(t + n, std::memory_order_release);
+      return n;
+    }
+
+    // pops up to count items and returns how many were popped
+    size_t popBatch(T *items, size_t count){
+      size_t h = head.load(std::memory_order_relaxed);
+      if(cachedTail - h < count){
+        cachedTail = tail.load(std::memory_order_acquire);
+      }
+      size_t available = cachedTail - h;
+      size_t n = count < available ? count : available;
+      for(size_t i = 0; i < n; i++){
+        items[i] = slots[(h + i) & mask];
+      }
+      head.store(h + n, std::memory_order_release);
+      return n;
+    }
+
+    bool tryPush(const T &item){
+      return pushBatch(&item, 1) == 1;
+    }
+
+    bool tryPop(T &item){
+      return popBatch(&item, 1) == 1;
+    }
+
+    void close(){
+      closed.store(true, std::memory_order_release);
+    }
+
+    bool isClosed() const{
+      return closed.load(std::memory_order_acquire);
+    }
+};
+
+//-----------------------------------------------
+/*
+* Multi producer, multi consumer ring buffer, every slot has a
+* sequence number which tells whether it is ready to be written
+* or read in the current lap, and producers and consumers claim
+* positions with a compare and swap on tail and head.
+*
+* The batch operations claim one slot at a time since the
+* slots of a range can be released by different consumers
+* in any order.
+*/
+//-----------------------------------------------
+template <typename T>
+class MpmcRingBuffer{
+  static_assert(std::is_trivially_copyable<T>::value, "ring buffer elements must be trivially copyable");
+  private:
+    struct Slot{
+      std::atomic<size_t> sequence;
+      T item;
+    };
+    const size_t mask;
+    std::unique_ptr<Slot[]> slots;
+    alignas(ringbuffer::cacheLine) std::atomic<size_t> head;
+    alignas(ringbuffer::cacheLine) std::atomic<size_t> tail;
+    alignas(ringbuffer::cacheLine) std::atomic<bool> closed;
+  public:
+    static const bool multiThreaded = true;
+
+    explicit MpmcRingBuffer(size_t capacity) : mask(ringbuffer::roundUpPow2(capacity) - 1),
+      slots(new Slot[mask + 1]), head(0), tail(0), closed(false) {
+      for(size_t i = 0; i <= mask; i++){
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+      }
+    }
+    MpmcRingBuffer(const MpmcRingBuffer &ring)=delete;
+    MpmcRingBuffer &operator=(const MpmcRingBuffer &ring)=delete;
+
+    size_t capacity() const{
+      return mask + 1;
+    }
+
+    bool tryPush(const T &item){
+      size_t position = tail.load(std::memory_order_relaxed);
+      while(true){
+        Slot &slot = slots[position & mask];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if(sequence == position){
+          if(tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)){
+            slot.item = item;
+            slot.sequence.store(position + 1, std::memory_order_release);
+            return true;
+          }
+        }
+        else if(sequence < position){
+          return false; // full
+        }
+        else{
+          position = tail.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    bool tryPop(T &item){
+      size_t position = head.load(std::memory_order_relaxed);
+      while(true){
+        Slot &slot = slots[position & mask];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if(sequence == position + 1){
+          if(head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)){
+            item = slot.item;
+            slot.sequence.store(position + mask + 1, std::memory_order_release);
+            return true;
+          }
+        }
+        else if(sequence < position + 1){
+          return false; // empty
+        }
+        else{
+          position = head.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    // pushes up to count items and returns how many were pushed
+    size_t pushBatch(const T *items, size_t count){
+      size_t n = 0;
+      while(n < count && tryPush(items[n])){
+        n++;
+      }
+      return n;
+    }
+
+    // pops up to count items and returns how many were popped
+    size_t popBatch(T *items, size_t count){
+      size_t n = 0;
+      while(n < count && tryPop(items[n])){
+        n++;
+      }
+      return n;
+    }
+
+    void close(){
+      closed.store(true, std::memory_order_release);
+    }
+
+    bool isClosed() const{
+      return closed.load(std::memory_order_acquire);
+    }
+};
+#endif
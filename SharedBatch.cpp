@@ -0,0 +1,424 @@
+//-----------------------------------------------
+/**
+* This is the implementation file for SharedMat2x2Region and
+* ShardedBatchExecutor classes.
+*
+* The region starts with a header of one cache line, the size
+* and the number of views, followed by the arrays a, b, c, d of
+* view 0, then of view 1 and so on, each array starting on a
+* cache line.
+*
+* The executor keeps the operation, the stop flag and the
+* status of every worker in a small anonymous shared mapping.
+* They are written before the eventfd which wakes the other
+* side, and the write and read of the eventfd order them.
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstdint>
+#include <stdexcept>
+#include <system_error>
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "SharedBatch.h"
+
+using namespace std;
+
+namespace {
+  const uint64_t regionMagic = 0x4d617432783252ULL; // "Mat2x2R"
+  const size_t headerBytes = 64;
+  const size_t cacheLineDoubles = 8;
+  const int pollMilliseconds = 50; // how often a waiting run() checks for dead workers
+
+  enum {operationSlot, stopSlot, statusSlot};
+  enum {statusDone, statusFailed};
+
+  struct RegionHeader{
+    uint64_t magic;
+    uint64_t size;
+    uint64_t views;
+  };
+
+  void throwSystemError(const char *what){
+    throw system_error(errno, generic_category(), what);
+  }
+
+  size_t regionBytes(size_t size, size_t views, size_t &stride){
+    stride = (size + cacheLineDoubles - 1) / cacheLineDoubles * cacheLineDoubles;
+    return headerBytes + (views * 4 * stride * sizeof(double));
+  }
+
+  // writes one to the eventfd, retrying if a signal interrupts it
+  void signalEvent(int fd){
+    uint64_t one = 1;
+    while(write(fd, &one, sizeof(one)) < 0 && errno == EINTR){
+    }
+  }
+
+  // blocks until the eventfd is signalled and resets it, returns false on an error
+  bool waitEvent(int fd){
+    uint64_t value;
+    ssize_t result;
+    while((result = read(fd, &value, sizeof(value))) < 0 && errno == EINTR){
+    }
+    return result == sizeof(value);
+  }
+
+  int createEvent(){
+    int fd = eventfd(0, EFD_CLOEXEC);
+    if(fd < 0){
+      throwSystemError("eventfd");
+    }
+    return fd;
+  }
+
+  // true if /proc/self/task, which has one entry per thread, has exactly one
+  bool isSingleThreaded(){
+    DIR *dir = opendir("/proc/self/task");
+    if(dir == NULL){
+      return false;
+    }
+    size_t threads = 0;
+    while(dirent *entry = readdir(dir)){
+      threads += entry->d_name[0] != '.';
+    }
+    closedir(dir);
+    return threads == 1;
+  }
+}
+
+//-----------------------------------------------
+/*
+* Constructor for the region, it creates the shared memory
+* object, which must not exist yet, and maps it. ftruncate
+* fills it with zeros, so every matrix starts as zero.
+*/
+//-----------------------------------------------
+SharedMat2x2Region::SharedMat2x2Region(const string &name, size_t size, size_t views)
+    : regionName(name), owner(true), memory(MAP_FAILED), matrixCount(size), viewCount(views) {
+  bytes = regionBytes(size, views, stride);
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if(fd < 0){
+    throwSystemError("shm_open");
+  }
+  if(ftruncate(fd, (off_t) bytes) < 0){
+    int error = errno;
+    close(fd);
+    shm_unlink(name.c_str());
+    throw system_error(error, generic_category(), "ftruncate");
+  }
+  memory = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  int error = errno;
+  close(fd);
+  if(memory == MAP_FAILED){
+    shm_unlink(name.c_str());
+    throw system_error(error, generic_category(), "mmap");
+  }
+  RegionHeader *header = static_cast<RegionHeader *>(memory);
+  header->size = size;
+  header->views = views;
+  header->magic = regionMagic;
+}
+
+//-----------------------------------------------
+/*
+* This is the constructor used by attach(), it maps the
+* object behind fd, which it closes, and checks the header.
+*/
+//-----------------------------------------------
+SharedMat2x2Region::SharedMat2x2Region(const string &name, int fd)
+    : regionName(name), owner(false), memory(MAP_FAILED), bytes(0), matrixCount(0), viewCount(0), stride(0) {
+  struct stat info;
+  if(fstat(fd, &info) < 0){
+    int error = errno;
+    close(fd);
+    throw system_error(error, generic_category(), "fstat");
+  }
+  bytes = (size_t) info.st_size;
+  if(bytes >= headerBytes){
+    memory = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  int error = errno;
+  close(fd);
+  if(memory == MAP_FAILED){
+    if(bytes < headerBytes){
+      throw invalid_argument("invalid argument");
+    }
+    throw system_error(error, generic_category(), "mmap");
+  }
+  const RegionHeader *header = static_cast<const RegionHeader *>(memory);
+  size_t expected = regionBytes(header->size, header->views, stride);
+  if(header->magic != regionMagic || expected != bytes){
+    munmap(memory, bytes);
+    throw invalid_argument("invalid argument");
+  }
+  matrixCount = header->size;
+  viewCount = header->views;
+}
+
+SharedMat2x2Region::~SharedMat2x2Region(){
+  munmap(memory, bytes);
+  if(owner){
+    shm_unlink(regionName.c_str());
+  }
+}
+
+//-----------------------------------------------
+/*
+* This function maps a region created by another process, it
+* throws system_error if there is no region with that name
+* and invalid_argument error if the object isn't a region.
+*/
+//-----------------------------------------------
+unique_ptr<SharedMat2x2Region> SharedMat2x2Region::attach(const string &name){
+  int fd = shm_open(name.c_str(), O_RDWR, 0);
+  if(fd < 0){
+    throwSystemError("shm_open");
+  }
+  return unique_ptr<SharedMat2x2Region>(new SharedMat2x2Region(name, fd));
+}
+
+const string &SharedMat2x2Region::name() const{
+  return regionName;
+}
+
+size_t SharedMat2x2Region::size() const{
+  return matrixCount;
+}
+
+size_t SharedMat2x2Region::views() const{
+  return viewCount;
+}
+
+//-----------------------------------------------
+/*
+* This function returns the view i of the region, it throws
+* invalid_argument error if i isn't less than views().
+*/
+//-----------------------------------------------
+Mat2x2BatchView<double> SharedMat2x2Region::view(size_t i) const{
+  if(i >= viewCount){
+    throw invalid_argument("invalid argument");
+  }
+  double *first = reinterpret_cast<double *>(static_cast<char *>(memory) + headerBytes) + (i * 4 * stride);
+  return Mat2x2BatchView<double>(first, first + stride, first + (2 * stride), first + (3 * stride), matrixCount);
+}
+
+//-----------------------------------------------
+/*
+* Constructor for the executor, it maps the shared control
+* block and forks one process per worker. Every worker has
+* its own start and done eventfd.
+*/
+//-----------------------------------------------
+ShardedBatchExecutor::ShardedBatchExecutor(SharedMat2x2Region &region1, size_t workers, Job job1)
+    : region(region1), job(job1), control(NULL), pids(workers, -1), startEvents(workers, -1), doneEvents(workers, -1) {
+  if(workers == 0){
+    throw invalid_argument("invalid argument");
+  }
+  void *memory = mmap(NULL, (statusSlot + workers) * sizeof(int), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if(memory == MAP_FAILED){
+    throwSystemError("mmap");
+  }
+  control = static_cast<int *>(memory);
+  try{
+    for(size_t i = 0; i < workers; i++){
+      startWorker(i);
+    }
+  }
+  catch(...){
+    shutdown();
+    throw;
+  }
+}
+
+ShardedBatchExecutor::~ShardedBatchExecutor(){
+  shutdown();
+}
+
+//-----------------------------------------------
+/*
+* This function sets the stop flag, wakes every worker,
+* waits for them to exit and releases the eventfds and the
+* control block.
+*/
+//-----------------------------------------------
+void ShardedBatchExecutor::shutdown(){
+  control[stopSlot] = 1;
+  for(size_t i = 0; i < pids.size(); i++){
+    if(pids[i] > 0){
+      signalEvent(startEvents[i]);
+      waitpid(pids[i], NULL, 0);
+    }
+    if(startEvents[i] >= 0){
+      close(startEvents[i]);
+    }
+    if(doneEvents[i] >= 0){
+      close(doneEvents[i]);
+    }
+    pids[i] = -1;
+    startEvents[i] = doneEvents[i] = -1;
+  }
+  munmap(control, (statusSlot + pids.size()) * sizeof(int));
+}
+
+size_t ShardedBatchExecutor::workers() const{
+  return pids.size();
+}
+
+//-----------------------------------------------
+/*
+* This function creates the eventfds of a worker and forks
+* it, the child never returns from here. The child asks for
+* SIGKILL when the thread which forked it exits, and exits
+* itself if the parent is already gone by then, so a parent
+* which dies without the destructor doesn't leave orphans.
+*/
+//-----------------------------------------------
+void ShardedBatchExecutor::startWorker(size_t worker){
+  startEvents[worker] = createEvent();
+  doneEvents[worker] = createEvent();
+  pid_t parent = getpid();
+  pid_t pid = fork();
+  if(pid < 0){
+    throwSystemError("fork");
+  }
+  if(pid == 0){
+    if(prctl(PR_SET_PDEATHSIG, SIGKILL) < 0 || getppid() != parent){
+      _exit(1);
+    }
+    workerLoop(worker);
+  }
+  pids[worker] = pid;
+}
+
+//-----------------------------------------------
+/*
+* This function is the body of a worker process, it waits for
+* its start event, runs the job on its range and signals its
+* done event. It leaves with _exit so no destructor of the
+* parent, e.g the one which unlinks the region, runs in it.
+*/
+//-----------------------------------------------
+void ShardedBatchExecutor::workerLoop(size_t worker){
+  size_t count = pids.size();
+  while(waitEvent(startEvents[worker]) && !control[stopSlot]){
+    size_t first = region.size() * worker / count;
+    size_t last = region.size() * (worker + 1) / count;
+    int status = statusDone;
+    try{
+      job(region, control[operationSlot], first, last);
+    }
+    catch(...){
+      status = statusFailed;
+    }
+    control[statusSlot + worker] = status;
+    signalEvent(doneEvents[worker]);
+  }
+  _exit(0);
+}
+
+//-----------------------------------------------
+/*
+* This function starts a new worker in place of one which
+* died, with new eventfds since the old start event may still
+* hold an unread signal. A child forked from a process with
+* other threads only has a copy of their locks and may hang
+* on one, so the worker is only started while the process is
+* single-threaded. Otherwise it stays missing and the function
+* returns false, the next run() tries again.
+*/
+//-----------------------------------------------
+bool ShardedBatchExecutor::replaceWorker(size_t worker){
+  if(startEvents[worker] >= 0){
+    close(startEvents[worker]);
+    close(doneEvents[worker]);
+  }
+  startEvents[worker] = doneEvents[worker] = -1;
+  pids[worker] = -1;
+  if(!isSingleThreaded()){
+    return false;
+  }
+  startWorker(worker);
+  return true;
+}
+
+//-----------------------------------------------
+/*
+* This function runs the job with the given operation on
+* every range and waits until each worker is done or dead.
+* It throws runtime_error if any of them threw or died, the
+* dead ones are replaced before it throws. A worker which
+* couldn't be replaced because the process had other threads
+* is started here, or its range fails again.
+*/
+//-----------------------------------------------
+void ShardedBatchExecutor::run(int operation){
+  size_t count = pids.size();
+  control[operationSlot] = operation;
+  vector<bool> pending(count, false), dead(count, false);
+  size_t remaining = 0;
+  for(size_t i = 0; i < count; i++){
+    control[statusSlot + i] = statusFailed;
+    if(pids[i] > 0 || replaceWorker(i)){
+      signalEvent(startEvents[i]);
+      pending[i] = true;
+      remaining++;
+    }
+  }
+  vector<pollfd> fds;
+  vector<size_t> owners;
+  while(remaining > 0){
+    fds.clear();
+    owners.clear();
+    for(size_t i = 0; i < count; i++){
+      if(pending[i]){
+        pollfd fd = {doneEvents[i], POLLIN, 0};
+        fds.push_back(fd);
+        owners.push_back(i);
+      }
+    }
+    if(poll(fds.data(), fds.size(), pollMilliseconds) < 0 && errno != EINTR){
+      throwSystemError("poll");
+    }
+    for(size_t k = 0; k < fds.size(); k++){
+      size_t i = owners[k];
+      if(fds[k].revents & POLLIN){
+        waitEvent(doneEvents[i]);
+      }
+      else if(waitpid(pids[i], NULL, WNOHANG) == pids[i]){
+        dead[i] = true;
+      }
+      else{
+        continue;
+      }
+      pending[i] = false;
+      remaining--;
+    }
+  }
+  bool failed = false;
+  for(size_t i = 0; i < count; i++){
+    if(dead[i]){
+      replaceWorker(i);
+    }
+    failed = failed || dead[i] || control[statusSlot + i] != statusDone;
+  }
+  if(failed){
+    throw runtime_error("Worker process failed");
+  }
+}
+#endif
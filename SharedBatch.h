@@ -0,0 +1,113 @@
+//-----------------------------------------------
+/**
+* This is the header file for SharedMat2x2Region and
+* ShardedBatchExecutor classes, which run the Mat2x2Batch
+* kernels in several worker processes over POSIX shared memory.
+*
+* A SharedMat2x2Region is a shm_open + mmap region holding a
+* number of batch views of the same size, i.e four arrays of
+* doubles per view, so every process which maps it sees the
+* matrices in place and nothing is copied or serialized. The
+* process which creates a region unlinks its name when the
+* region is destroyed, other processes may attach to it by
+* name while it exists.
+*
+* A ShardedBatchExecutor forks its worker processes once, at
+* construction, and they inherit the mapping of the region.
+* run(operation) splits [0, size) of the region in one index
+* range per worker, wakes every worker with its own eventfd
+* and waits on the eventfds the workers write when their range
+* is done. The job is any function, it is called in the worker
+* with the region, the operation and the range, e.g
+*
+* ShardedBatchExecutor executor(region, 4, [](SharedMat2x2Region &r, int, size_t first, size_t last){
+*   batchMultiply(r.view(0).slice(first, last), r.view(1).slice(first, last), r.view(2).slice(first, last));
+* });
+* executor.run(0);
+*
+* A worker which throws or dies, e.g with a segmentation fault,
+* only fails its own range. run() throws runtime_error after
+* the other workers are done and a worker which died is
+* replaced, so the next run() works again.
+*
+* The workers are processes, the job must not use the
+* ThreadPool or any other thread of the parent. A forked child
+* only has the forking thread and a copy of the locks the
+* other threads held, so the executor should be created while
+* the process is single-threaded, i.e before ThreadPool is
+* first used. A dead worker is only replaced while the process
+* is single-threaded, until then its range fails in every
+* run().
+*
+* Every worker gets SIGKILL when the thread which forked it
+* exits, so no worker outlives a parent which crashed. That
+* thread, the one which created the executor or the one whose
+* run() replaced the worker, must outlive the executor.
+*
+* Both classes are only available on Linux, with glibc older
+* than 2.34 the program must be linked with -lrt for shm_open.
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+#ifndef SHAREDBATCH_H
+#define SHAREDBATCH_H
+#ifdef __linux__
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include "Mat2x2Batch.h"
+
+class SharedMat2x2Region{
+  private:
+    std::string regionName;
+    bool owner; // created the region and unlinks its name
+    void *memory;
+    size_t bytes;
+    size_t matrixCount, viewCount;
+    size_t stride; // distance in doubles between two arrays
+    SharedMat2x2Region(const std::string &name, int fd);
+  public:
+    // ctor, creates the region with views batch views of size matrices each, all zero
+    SharedMat2x2Region(const std::string &name, size_t size, size_t views);
+    ~SharedMat2x2Region(); // dtor
+    SharedMat2x2Region(const SharedMat2x2Region &region)=delete;
+    SharedMat2x2Region &operator=(const SharedMat2x2Region &region)=delete;
+
+    static std::unique_ptr<SharedMat2x2Region> attach(const std::string &name); // maps an existing region
+
+    const std::string &name() const;
+    size_t size() const;
+    size_t views() const;
+    Mat2x2BatchView<double> view(size_t i) const;
+};
+
+class ShardedBatchExecutor{
+  public:
+    typedef std::function<void(SharedMat2x2Region &region, int operation, size_t first, size_t last)> Job;
+  private:
+    SharedMat2x2Region &region;
+    Job job;
+    int *control; // operation, stop flag and one status per worker, shared with the workers
+    std::vector<pid_t> pids;
+    std::vector<int> startEvents, doneEvents;
+    void startWorker(size_t worker);
+    void workerLoop(size_t worker);
+    bool replaceWorker(size_t worker);
+    void shutdown();
+  public:
+    ShardedBatchExecutor(SharedMat2x2Region &region, size_t workers, Job job); // ctor, forks the workers
+    ~ShardedBatchExecutor(); // dtor, stops the workers and waits for them
+    ShardedBatchExecutor(const ShardedBatchExecutor &executor)=delete;
+    ShardedBatchExecutor &operator=(const ShardedBatchExecutor &executor)=delete;
+
+    size_t workers() const;
+    void run(int operation); // runs the job on every range and waits for all of them
+};
+#endif
+#endif
@@ -0,0 +1,215 @@
+//-----------------------------------------------
+/**
+* This is the implementation file for SlidingWindowProduct and
+* SlidingWindowProductBatch classes.
+*
+* The batch keeps every slot of both stacks allocated, so after
+* the first pass through the window push and pop only copy and
+* multiply. No multiply writes to one of its inputs, which
+* would send batchMultiply through its slower copying path.
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include "SlidingWindow.h"
+
+using namespace std;
+
+namespace {
+  void copyBatch(const Mat2x2BatchView<const double> &in, const Mat2x2BatchView<double> &out){
+    if(in.size != out.size){
+      throw invalid_argument("invalid argument");
+    }
+    memcpy(out.a, in.a, in.size * sizeof(double));
+    memcpy(out.b, in.b, in.size * sizeof(double));
+    memcpy(out.c, in.c, in.size * sizeof(double));
+    memcpy(out.d, in.d, in.size * sizeof(double));
+  }
+
+  void identity(const Mat2x2BatchView<double> &out){
+    for(size_t i = 0; i < out.size; i++){
+      out.a[i] = 1;
+      out.b[i] = 0;
+      out.c[i] = 0;
+      out.d[i] = 1;
+    }
+  }
+}
+
+//-----------------------------------------------
+/*
+* Constructor for the window, it takes the number of
+* matrices the window keeps.
+*/
+//-----------------------------------------------
+SlidingWindowProduct::SlidingWindowProduct(size_t window) : capacity(window), backProduct(1, 0, 0, 1) {
+  if(window == 0){
+    throw invalid_argument("invalid argument");
+  }
+  back.reserve(window);
+  front.reserve(window);
+}
+
+//-----------------------------------------------
+/*
+* This function adds the newest matrix, the oldest one is
+* dropped first if the window is full.
+*/
+//-----------------------------------------------
+void SlidingWindowProduct::push(const Mat2x2 &mat){
+  if(size() == capacity){
+    pop();
+  }
+  backProduct = back.empty() ? mat : mat * backProduct;
+  back.push_back(mat);
+}
+
+//-----------------------------------------------
+/*
+* This function drops the oldest matrix. If the front stack
+* is empty the back stack is moved over first, newest matrix
+* at the bottom, building the products down to the oldest.
+*/
+//-----------------------------------------------
+void SlidingWindowProduct::pop(){
+  if(empty()){
+    throw out_of_range("Window is empty");
+  }
+  if(front.empty()){
+    for(size_t i = back.size(); i-- > 0;){
+      front.push_back(front.empty() ? back[i] : front.back() * back[i]);
+    }
+    back.clear();
+    backProduct = Mat2x2(1, 0, 0, 1);
+  }
+  front.pop_back();
+}
+
+void SlidingWindowProduct::clear(){
+  back.clear();
+  front.clear();
+  backProduct = Mat2x2(1, 0, 0, 1);
+}
+
+size_t SlidingWindowProduct::size() const{
+  return back.size() + front.size();
+}
+
+size_t SlidingWindowProduct::window() const{
+  return capacity;
+}
+
+bool SlidingWindowProduct::empty() const{
+  return size() == 0;
+}
+
+Mat2x2 SlidingWindowProduct::product() const{
+  if(front.empty()){
+    return backProduct;
+  }
+  return back.empty() ? front.back() : backProduct * front.back();
+}
+
+//-----------------------------------------------
+/*
+* Constructor for the batch, it takes the number of streams
+* and the number of matrices every window keeps.
+*/
+//-----------------------------------------------
+SlidingWindowProductBatch::SlidingWindowProductBatch(size_t streams, size_t window)
+    : streamCount(streams), capacity(window), back(window, Mat2x2Batch<double>(streams)),
+      front(window, Mat2x2Batch<double>(streams)), backProduct(streams), nextBackProduct(streams), backSize(0), frontSize(0) {
+  if(window == 0){
+    throw invalid_argument("invalid argument");
+  }
+}
+
+//-----------------------------------------------
+/*
+* This function adds the newest matrix of every stream, it
+* throws invalid_argument error if mats doesn't have one
+* matrix per stream.
+*/
+//-----------------------------------------------
+void SlidingWindowProductBatch::push(const Mat2x2BatchView<const double> &mats){
+  if(mats.size != streamCount){
+    throw invalid_argument("invalid argument");
+  }
+  if(size() == capacity){
+    pop();
+  }
+  if(backSize == 0){
+    copyBatch(mats, backProduct.view());
+  }
+  else{
+    batchMultiply(mats, backProduct.view(), nextBackProduct.view());
+    swap(backProduct, nextBackProduct);
+  }
+  copyBatch(mats, back[backSize].view());
+  backSize++;
+}
+
+void SlidingWindowProductBatch::pop(){
+  if(size() == 0){
+    throw out_of_range("Window is empty");
+  }
+  if(frontSize == 0){
+    for(size_t i = backSize; i-- > 0;){
+      if(frontSize == 0){
+        copyBatch(back[i].view(), front[0].view());
+      }
+      else{
+        batchMultiply(front[frontSize - 1].view(), back[i].view(), front[frontSize].view());
+      }
+      frontSize++;
+    }
+    backSize = 0;
+  }
+  frontSize--;
+}
+
+void SlidingWindowProductBatch::clear(){
+  backSize = frontSize = 0;
+}
+
+size_t SlidingWindowProductBatch::size() const{
+  return backSize + frontSize;
+}
+
+size_t SlidingWindowProductBatch::streams() const{
+  return streamCount;
+}
+
+size_t SlidingWindowProductBatch::window() const{
+  return capacity;
+}
+
+//-----------------------------------------------
+/*
+* This function writes the product of every window to out,
+* the identity if the windows are empty.
+*/
+//-----------------------------------------------
+void SlidingWindowProductBatch::product(const Mat2x2BatchView<double> &out) const{
+  if(out.size != streamCount){
+    throw invalid_argument("invalid argument");
+  }
+  if(size() == 0){
+    identity(out);
+  }
+  else if(frontSize == 0){
+    copyBatch(backProduct.view(), out);
+  }
+  else if(backSize == 0){
+    copyBatch(front[frontSize - 1].view(), out);
+  }
+  else{
+    batchMultiply(backProduct.view(), front[frontSize - 1].view(), out);
+  }
+}
@@ -0,0 +1,277 @@
+//-----------------------------------------------
+/**
+* This is the implementation file for StreamPipeline class
+* and the stages in the stream namespace. The calling thread
+* reads the chunks, the ThreadPool transforms them and a
+* writer thread prints them in order.
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include "StreamPipeline.h"
+
+using namespace std;
+
+namespace {
+  //-----------------------------------------------
+  /*
+  * This is a helper method which reads the next four numbers
+  * into mat. It returns false at the end of the input and
+  * throws invalid_argument error if the input has a token
+  * that isn't a number or ends in the middle of a matrix.
+  */
+  //-----------------------------------------------
+  bool readMatrix(istream &in, Mat2x2 &mat){
+    double values[4];
+    for(int i = 0; i < 4; i++){
+      if(!(in >> values[i])){
+        if(i == 0 && in.eof() && !in.bad()){
+          return false;
+        }
+        throw invalid_argument("Malformed matrix input");
+      }
+    }
+    mat = Mat2x2(values[0], values[1], values[2], values[3]);
+    return true;
+  }
+}
+
+//-----------------------------------------------
+/*
+* Following functions create the stages which are
+* composed with operator| into a StreamPipeline.
+*/
+//-----------------------------------------------
+stream::Read stream::read(istream &in, size_t chunkSize){
+  if(chunkSize == 0){
+    throw invalid_argument("invalid argument");
+  }
+  Read read = {&in, chunkSize};
+  return read;
+}
+
+stream::Map stream::map(function<Mat2x2(const Mat2x2 &)> fn){
+  Map map = {fn};
+  return map;
+}
+
+stream::Filter stream::filter(function<bool(const Mat2x2 &)> predicate){
+  Filter filter = {predicate};
+  return filter;
+}
+
+stream::Write stream::write(ostream &out){
+  Write write = {&out};
+  return write;
+}
+
+//-----------------------------------------------
+/*
+* Constructor for the class which takes the read stage,
+* the pipeline has no transforms and no output yet.
+*/
+//-----------------------------------------------
+StreamPipeline::StreamPipeline(const stream::Read &read) : source(read), sink(nullptr) {}
+
+//-----------------------------------------------
+/*
+* Following functions append a stage to the pipeline, map
+* and filter steps run in the order they are added, and the
+* write stage sets the output stream of the pipeline.
+*/
+//-----------------------------------------------
+StreamPipeline operator|(StreamPipeline pipeline, const stream::Map &map){
+  StreamPipeline::Step step;
+  step.fn = map.fn;
+  pipeline.steps.push_back(step);
+  return pipeline;
+}
+
+StreamPipeline operator|(StreamPipeline pipeline, const stream::Filter &filter){
+  StreamPipeline::Step step;
+  step.predicate = filter.predicate;
+  pipeline.steps.push_back(step);
+  return pipeline;
+}
+
+StreamPipeline operator|(StreamPipeline pipeline, const stream::Write &write){
+  pipeline.sink = write.out;
+  return pipeline;
+}
+
+StreamPipeline operator|(const stream::Read &read, const stream::Map &map){
+  return StreamPipeline(read) | map;
+}
+
+StreamPipeline operator|(const stream::Read &read, const stream::Filter &filter){
+  return StreamPipeline(read) | filter;
+}
+
+StreamPipeline operator|(const stream::Read &read, const stream::Write &write){
+  return StreamPipeline(read) | write;
+}
+
+//-----------------------------------------------
+/*
+* This is a helper method which runs every map and filter
+* step over one chunk, the matrices which are filtered out
+* are removed from the chunk.
+*/
+//-----------------------------------------------
+void StreamPipeline::process(vector<Mat2x2> &chunk) const{
+  size_t kept = 0;
+  for(size_t i = 0; i < chunk.size(); i++){
+    Mat2x2 mat = chunk[i];
+    bool keep = true;
+    for(size_t s = 0; s < steps.size() && keep; s++){
+      if(steps[s].fn){
+        mat = steps[s].fn(mat);
+      }
+      else{
+        keep = steps[s].predicate(mat);
+      }
+    }
+    if(keep){
+      chunk[kept++] = mat;
+    }
+  }
+  chunk.resize(kept);
+}
+
+//-----------------------------------------------
+/*
+* Following functions run the pipeline until the input
+* ends and return the number of matrices written to the
+* output.
+*
+* The first exception thrown by a map or filter step, i.e
+* inverse() of a singular matrix, stops the reading and is
+* rethrown once the chunks in flight are finished. The chunks
+* before the failed one are still written. Input which isn't
+* four numbers per matrix stops the reading the same way,
+* the matrices before it are written and invalid_argument
+* error is thrown.
+*
+* It throws invalid_argument error if the pipeline has no
+* write stage or maxInFlight is 0. It must not be called
+* from a task running on the same pool.
+*/
+//-----------------------------------------------
+size_t StreamPipeline::run(size_t maxInFlight){
+  return run(ThreadPool::instance(), maxInFlight);
+}
+
+size_t StreamPipeline::run(ThreadPool &pool, size_t maxInFlight){
+  if(sink == nullptr || maxInFlight == 0){
+    throw invalid_argument("invalid argument");
+  }
+  struct Chunk{
+    vector<Mat2x2> mats;
+    bool done;
+    exception_ptr error;
+  };
+  mutex lock;
+  condition_variable changed;
+  deque<shared_ptr<Chunk> > window; // chunks read but not written yet, in input order
+  bool finished = false;
+  bool failed = false;
+  exception_ptr error, parseError;
+  size_t written = 0;
+
+  thread writer([&]{
+    while(true){
+      shared_ptr<Chunk> chunk;
+      {
+        unique_lock<mutex> guard(lock);
+        changed.wait(guard, [&]{ return window.empty() ? finished : window.front()->done; });
+        if(window.empty()){
+          return;
+        }
+        chunk = window.front();
+        if(chunk->error && !failed){
+          failed = true;
+          error = chunk->error;
+        }
+      }
+      if(!failed){
+        for(size_t i = 0; i < chunk->mats.size(); i++){
+          *sink << chunk->mats[i];
+        }
+        written += chunk->mats.size();
+      }
+      lock_guard<mutex> guard(lock);
+      window.pop_front();
+      changed.notify_all();
+    }
+  });
+
+  istream &in = *source.in;
+  while(true){
+    {
+      unique_lock<mutex> guard(lock);
+      changed.wait(guard, [&]{ return window.size() < maxInFlight || failed; });
+      if(failed){
+        break;
+      }
+    }
+    shared_ptr<Chunk> chunk(new Chunk());
+    chunk->done = false;
+    chunk->mats.reserve(source.chunkSize);
+    try{
+      Mat2x2 mat;
+      while(chunk->mats.size() < source.chunkSize && readMatrix(in, mat)){
+        chunk->mats.push_back(mat);
+      }
+    }
+    catch(invalid_argument &){
+      parseError = current_exception();
+    }
+    size_t count = chunk->mats.size();
+    if(count == 0){
+      break;
+    }
+    {
+      lock_guard<mutex> guard(lock);
+      window.push_back(chunk);
+    }
+    const StreamPipeline *self = this;
+    pool.submit([self, chunk, &lock, &changed]{
+      try{
+        self->process(chunk->mats);
+      }
+      catch(...){
+        chunk->error = current_exception();
+      }
+      // notify while holding the lock, run() may return as soon as it is released
+      lock_guard<mutex> guard(lock);
+      chunk->done = true;
+      changed.notify_all();
+    });
+    if(count < source.chunkSize || parseError){
+      break;
+    }
+  }
+  {
+    lock_guard<mutex> guard(lock);
+    finished = true;
+    changed.notify_all();
+  }
+  writer.join();
+  if(error){
+    rethrow_exception(error);
+  }
+  if(parseError){
+    rethrow_exception(parseError);
+  }
+  return written;
+}
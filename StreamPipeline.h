@@ -0,0 +1,85 @@
+//-----------------------------------------------
+/**
+* This is the header file for StreamPipeline class, which
+* reads Mat2x2 objects from an input stream, transforms them
+* and writes them to an output stream. A pipeline is composed
+* from the stages in the stream namespace, i.e
+*
+* (stream::read(in) | stream::map(&Mat2x2::inverse)
+*   | stream::filter(&Mat2x2::isSymmetric) | stream::write(out)).run();
+*
+* The input is read in chunks of matrices, every chunk runs
+* the map and filter stages on the ThreadPool while the next
+* chunks are being read, and a writer thread prints the
+* finished chunks in their original order with operator<<.
+* At most maxInFlight chunks are held in memory, when that
+* many are waiting the reader stops until the writer catches
+* up.
+*
+* The input is four numbers a, b, c, d per matrix, the same
+* as operator>> but without its prompt. Any other token, or
+* an input which ends in the middle of a matrix, makes run()
+* throw invalid_argument error after writing the matrices
+* before it.
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+#ifndef STREAMPIPELINE_H
+#define STREAMPIPELINE_H
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <vector>
+#include "Mat2x2.h"
+#include "ThreadPool.h"
+
+namespace stream {
+  struct Read{
+    std::istream *in;
+    size_t chunkSize;
+  };
+  struct Map{
+    std::function<Mat2x2(const Mat2x2 &)> fn;
+  };
+  struct Filter{
+    std::function<bool(const Mat2x2 &)> predicate;
+  };
+  struct Write{
+    std::ostream *out;
+  };
+
+  Read read(std::istream &in, size_t chunkSize = 1024);
+  Map map(std::function<Mat2x2(const Mat2x2 &)> fn);
+  Filter filter(std::function<bool(const Mat2x2 &)> predicate);
+  Write write(std::ostream &out);
+}
+
+class StreamPipeline{
+  private:
+    struct Step{
+      std::function<Mat2x2(const Mat2x2 &)> fn; // empty for filter steps
+      std::function<bool(const Mat2x2 &)> predicate;
+    };
+    stream::Read source;
+    std::vector<Step> steps;
+    std::ostream *sink;
+    void process(std::vector<Mat2x2> &chunk) const;
+  public:
+    StreamPipeline(const stream::Read &read); // ctor
+
+    friend StreamPipeline operator|(StreamPipeline pipeline, const stream::Map &map);
+    friend StreamPipeline operator|(StreamPipeline pipeline, const stream::Filter &filter);
+    friend StreamPipeline operator|(StreamPipeline pipeline, const stream::Write &write);
+
+    // runs the pipeline until the input ends and returns the number of matrices written
+    size_t run(size_t maxInFlight = 8);
+    size_t run(ThreadPool &pool, size_t maxInFlight = 8);
+};
+
+StreamPipeline operator|(const stream::Read &read, const stream::Map &map);
+StreamPipeline operator|(const stream::Read &read, const stream::Filter &filter);
+StreamPipeline operator|(const stream::Read &read, const stream::Write &write);
+#endif
@@ -0,0 +1,347 @@
+//-----------------------------------------------
+/**
+* This is the implementation file for ThreadPool class, a
+* work-stealing pool where every worker owns a deque of tasks.
+* A worker runs its own tasks in LIFO order and steals the
+* oldest tasks of the other workers when its deque is empty.
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include "ThreadPool.h"
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace std;
+
+namespace {
+  // pool and worker index of the calling thread, null for threads outside any pool
+  thread_local ThreadPool *currentPool = nullptr;
+  thread_local size_t currentIndex = 0;
+
+  //-----------------------------------------------
+  /*
+  * This is a helper method which parses a sysfs list such
+  * as "0-3,8,10-11" into the numbers it contains.
+  */
+  //-----------------------------------------------
+  vector<size_t> parseList(const string &list){
+    vector<size_t> numbers;
+    stringstream ranges(list);
+    string range;
+    while(getline(ranges, range, ',')){
+      size_t dash = range.find('-');
+      size_t first = stoul(range.substr(0, dash));
+      size_t last = dash == string::npos ? first : stoul(range.substr(dash + 1));
+      for(size_t i = first; i <= last; i++){
+        numbers.push_back(i);
+      }
+    }
+    return numbers;
+  }
+
+  vector<size_t> readList(const string &path){
+    ifstream file(path);
+    string list;
+    if(!(file >> list)){
+      return vector<size_t>();
+    }
+    return parseList(list);
+  }
+
+#ifdef __linux__
+  //-----------------------------------------------
+  /*
+  * This is a helper method which returns the cpus of every
+  * online NUMA node that this process is allowed to run on.
+  * Nodes without such cpus, i.e memory only nodes, are left
+  * out, and an empty vector is returned if sysfs has no node
+  * information.
+  */
+  //-----------------------------------------------
+  vector<cpu_set_t> nodeCpuSets(){
+    vector<cpu_set_t> sets;
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if(sched_getaffinity(0, sizeof(allowed), &allowed) != 0){
+      return sets;
+    }
+    vector<size_t> nodes = readList("/sys/devices/system/node/online");
+    for(size_t i = 0; i < nodes.size(); i++){
+      vector<size_t> cpus = readList("/sys/devices/system/node/node" + to_string(nodes[i]) + "/cpulist");
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      for(size_t j = 0; j < cpus.size(); j++){
+        if(cpus[j] < CPU_SETSIZE && CPU_ISSET(cpus[j], &allowed)){
+          CPU_SET(cpus[j], &set);
+        }
+      }
+      if(CPU_COUNT(&set) > 0){
+        sets.push_back(set);
+      }
+    }
+    return sets;
+  }
+#endif
+}
+
+//-----------------------------------------------
+/*
+* Constructor for the class which takes the number of
+* worker threads, if 0 is passed then it uses the
+* value of defaultThreadCount().
+*
+* Workers are spread evenly over the NUMA nodes and, on a
+* machine with more than one node, every worker is pinned to
+* the cpus of its node, so the tasks it steals from the same
+* node first run next to the memory they were queued with.
+* If pinning fails the worker runs unpinned.
+*/
+//-----------------------------------------------
+ThreadPool::ThreadPool(size_t threadCount) : pending(0), stopping(false), nextQueue(0) {
+  if(threadCount == 0){
+    threadCount = defaultThreadCount();
+  }
+#ifdef __linux__
+  vector<cpu_set_t> nodeCpus = nodeCpuSets();
+  size_t nodes = nodeCpus.empty() ? 1 : nodeCpus.size();
+#else
+  size_t nodes = 1;
+#endif
+  for(size_t i = 0; i < threadCount; i++){
+    unique_ptr<Worker> worker(new Worker());
+    worker->node = (i * nodes) / threadCount;
+    workers.push_back(move(worker));
+  }
+  for(size_t i = 0; i < threadCount; i++){
+    threads.push_back(thread(&ThreadPool::workerLoop, this, i));
+#ifdef __linux__
+    if(nodes > 1){
+      pthread_setaffinity_np(threads[i].native_handle(), sizeof(cpu_set_t), &nodeCpus[workers[i]->node]);
+    }
+#endif
+  }
+}
+
+//-----------------------------------------------
+/*
+* Destructor for the class, the workers keep running
+* until every queued task is finished and then they
+* are joined.
+*/
+//-----------------------------------------------
+ThreadPool::~ThreadPool(){
+  {
+    lock_guard<mutex> guard(sleepLock);
+    stopping = true;
+  }
+  wake.notify_all();
+  for(size_t i = 0; i < threads.size(); i++){
+    threads[i].join();
+  }
+}
+
+//-----------------------------------------------
+/*
+* This function returns the number of worker threads
+* owned by the pool.
+*/
+//-----------------------------------------------
+size_t ThreadPool::size() const{
+  return workers.size();
+}
+
+//-----------------------------------------------
+/*
+* This function queues a task on the pool. A task submitted
+* from one of the workers goes to the back of that
+* worker's own deque, any other thread hands the tasks
+* out to the workers in a round robin order.
+*
+* The pending count is raised before the task is published,
+* so a worker that takes it at once can't bring the count
+* below zero.
+*/
+//-----------------------------------------------
+void ThreadPool::submit(function<void()> task){
+  size_t index;
+  if(currentPool == this){
+    index = currentIndex;
+  }
+  else{
+    index = nextQueue.fetch_add(1, memory_order_relaxed) % workers.size();
+  }
+  {
+    lock_guard<mutex> guard(sleepLock);
+    pending++;
+  }
+  {
+    lock_guard<mutex> guard(workers[index]->lock);
+    workers[index]->tasks.push_back(move(task));
+  }
+  wake.notify_one();
+}
+
+//-----------------------------------------------
+/*
+* This function runs one queued task on the calling thread
+* and returns true, or returns false if there was nothing
+* to run. Threads which wait on a group of tasks call it
+* so that they help instead of blocking a core.
+*/
+//-----------------------------------------------
+bool ThreadPool::runPendingTask(){
+  function<void()> task;
+  bool found;
+  if(currentPool == this){
+    found = popLocal(currentIndex, task) || steal(currentIndex, task);
+  }
+  else{
+    found = steal(workers.size(), task);
+  }
+  if(!found){
+    return false;
+  }
+  task();
+  return true;
+}
+
+//-----------------------------------------------
+/*
+* This function returns the number of cpus the process
+* is allowed to run on, which is the default size of
+* a pool. It never returns less than 1.
+*/
+//-----------------------------------------------
+size_t ThreadPool::defaultThreadCount(){
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if(sched_getaffinity(0, sizeof(set), &set) == 0 && CPU_COUNT(&set) > 0){
+    return (size_t) CPU_COUNT(&set);
+  }
+#endif
+  unsigned int count = thread::hardware_concurrency();
+  return count == 0 ? 1 : count;
+}
+
+//-----------------------------------------------
+/*
+* This function returns the number of online NUMA nodes
+* by reading the node list, i.e "0-1,3", from sysfs. On
+* machines without that information it returns 1.
+*/
+//-----------------------------------------------
+size_t ThreadPool::numaNodeCount(){
+  size_t count = readList("/sys/devices/system/node/online").size();
+  return count == 0 ? 1 : count;
+}
+
+//-----------------------------------------------
+/*
+* This function returns the pool owned by the library,
+* which is created with the default size the first time
+* it is used.
+*/
+//-----------------------------------------------
+ThreadPool &ThreadPool::instance(){
+  static ThreadPool pool;
+  return pool;
+}
+
+//-----------------------------------------------
+/*
+* This is a helper method which takes the newest task
+* from the deque of the given worker.
+*/
+//-----------------------------------------------
+bool ThreadPool::popLocal(size_t index, function<void()> &task){
+  Worker &worker = *workers[index];
+  {
+    lock_guard<mutex> guard(worker.lock);
+    if(worker.tasks.empty()){
+      return false;
+    }
+    task = move(worker.tasks.back());
+    worker.tasks.pop_back();
+  }
+  taken();
+  return true;
+}
+
+//-----------------------------------------------
+/*
+* This is a helper method which takes the oldest task from
+* another worker. The victims on the same NUMA node as the
+* thief are tried first, then the rest of the pool. A thief
+* index equal to size() stands for a thread outside the pool.
+*/
+//-----------------------------------------------
+bool ThreadPool::steal(size_t thief, function<void()> &task){
+  size_t count = workers.size();
+  size_t node = thief < count ? workers[thief]->node : workers[0]->node;
+  for(int pass = 0; pass < 2; pass++){
+    for(size_t offset = 1; offset <= count; offset++){
+      size_t victim = (thief + offset) % count;
+      if(victim == thief || (workers[victim]->node == node) != (pass == 0)){
+        continue;
+      }
+      Worker &worker = *workers[victim];
+      lock_guard<mutex> guard(worker.lock);
+      if(!worker.tasks.empty()){
+        task = move(worker.tasks.front());
+        worker.tasks.pop_front();
+        break;
+      }
+    }
+    if(task){
+      taken();
+      return true;
+    }
+  }
+  return false;
+}
+
+//-----------------------------------------------
+/*
+* This is a helper method which updates the pending count
+* after a task has been removed from one of the deques.
+*/
+//-----------------------------------------------
+void ThreadPool::taken(){
+  lock_guard<mutex> guard(sleepLock);
+  pending--;
+}
+
+//-----------------------------------------------
+/*
+* This is the loop run by every worker thread, it runs its
+* own tasks, then stolen ones, and sleeps when the whole
+* pool is out of work.
+*/
+//-----------------------------------------------
+void ThreadPool::workerLoop(size_t index){
+  currentPool = this;
+  currentIndex = index;
+  while(true){
+    function<void()> task;
+    if(popLocal(index, task) || steal(index, task)){
+      task();
+      continue;
+    }
+    unique_lock<mutex> guard(sleepLock);
+    wake.wait(guard, [this]{ return pending > 0 || stopping; });
+    if(pending == 0 && stopping){
+      return;
+    }
+  }
+}
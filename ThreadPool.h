@@ -0,0 +1,64 @@
+//-----------------------------------------------
+/**
+* This is the header file for ThreadPool class. It is the
+* library owned work-stealing pool which runs the parallel
+* Mat2x2 operations declared in Parallel.h
+*
+* Every worker owns a task deque, it pops its own tasks from
+* the back and when it runs out of work it steals from the
+* front of the other workers deques, trying the workers that
+* sit on the same NUMA node first. On machines with more than
+* one node every worker is pinned to the cpus of its node.
+*
+* If no thread count is provided then the pool is sized to
+* the number of cpus this process is allowed to run on.
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+class ThreadPool{
+  private:
+    struct Worker{
+      std::mutex lock;
+      std::deque<std::function<void()> > tasks;
+      size_t node; // NUMA node the worker is assigned and pinned to
+    };
+    std::vector<std::unique_ptr<Worker> > workers;
+    std::vector<std::thread> threads;
+    std::mutex sleepLock;
+    std::condition_variable wake;
+    size_t pending; // queued but not yet started tasks, guarded by sleepLock
+    bool stopping; // guarded by sleepLock
+    std::atomic<size_t> nextQueue;
+    bool popLocal(size_t index, std::function<void()> &task);
+    bool steal(size_t thief, std::function<void()> &task);
+    void taken();
+    void workerLoop(size_t index);
+  public:
+    explicit ThreadPool(size_t threadCount = 0); // ctor
+    ~ThreadPool(); // dtor, finishes the queued tasks and joins the workers
+    ThreadPool(const ThreadPool &pool)=delete;
+    ThreadPool &operator=(const ThreadPool &pool)=delete;
+
+    size_t size() const;
+    void submit(std::function<void()> task);
+    bool runPendingTask(); // runs one queued task on the calling thread
+
+    static size_t defaultThreadCount();
+    static size_t numaNodeCount();
+    static ThreadPool &instance(); // the library owned pool
+};
+#endif
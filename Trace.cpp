@@ -0,0 +1,514 @@
+//-----------------------------------------------
+/**
+* This is the implementation file for the trace recorder, the
+* TraceScope which feeds it and the trace replay.
+*
+* Every thread appends its records to one buffer under a mutex,
+* the buffer is written to the file when it holds 64 KiB. The
+* TraceScope only takes the clock and copies the operands if
+* the recorder is recording, otherwise it is a thread_local
+* increment and an atomic load.
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include "Trace.h"
+
+using namespace std;
+
+namespace {
+  const char traceMagic[8] = {'M', '2', 'X', '2', 'T', 'R', 'C', '1'};
+  const size_t bufferBytes = 1 << 16;
+  const size_t matrixBytes = 4 * sizeof(double);
+  const size_t replayWindow = 64; // consecutive records timed together by replayTrace()
+
+  thread_local int depth = 0; // number of open TraceScope objects on this thread
+
+  const char *const opNames[] = {
+    "+=", "-=", "*=", "/=",
+    "+= x", "-= x", "*= x", "/= x",
+    "+", "-", "*", "/",
+    "+ x", "- x", "* x", "/ x",
+    "x +", "x -", "x *", "x /",
+    "==", "!=",
+    "++pre", "--pre", "post++", "post--", "unary +", "unary -",
+    "inverse", "tryInverse", "transpose", "determinant", "preciseDeterminant", "discriminant", "trace",
+    "isSymmetric", "isSimilar",
+    "operator()(int)",
+    "operator()()",
+    "operator[]", "operator[] const",
+    "<<", ">>"
+  };
+  static_assert(sizeof(opNames) / sizeof(opNames[0]) == (size_t) TraceOp::Count, "one name per TraceOp");
+
+  size_t operandBytes(TraceOp op){
+    switch(traceOperandOf(op)){
+      case TraceOperand::Matrix:
+        return matrixBytes;
+      case TraceOperand::Scalar:
+        return sizeof(double);
+      case TraceOperand::Integer:
+        return sizeof(int32_t);
+      default:
+        return 0;
+    }
+  }
+
+  uint64_t elapsedNanoseconds(chrono::steady_clock::time_point start, chrono::steady_clock::time_point end){
+    return (uint64_t) chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+  }
+
+  //-----------------------------------------------
+  /*
+  * This is a helper method which executes one record on
+  * copies of its operands and returns a number derived from
+  * the result, so the compiler can't drop the operation.
+  * input is the text which operator>> reads for an Input
+  * record.
+  */
+  //-----------------------------------------------
+  double execute(const TraceRecord &record, const string &input){
+    Mat2x2 lhs = record.lhs;
+    const Mat2x2 &rhs = record.rhs;
+    double x = record.scalar;
+    Mat2x2 result;
+    switch(record.op){
+      case TraceOp::AddAssign: result = (lhs += rhs); break;
+      case TraceOp::SubtractAssign: result = (lhs -= rhs); break;
+      case TraceOp::MultiplyAssign: result = (lhs *= rhs); break;
+      case TraceOp::DivideAssign: result = (lhs /= rhs); break;
+      case TraceOp::AddAssignScalar: result = (lhs += x); break;
+      case TraceOp::SubtractAssignScalar: result = (lhs -= x); break;
+      case TraceOp::MultiplyAssignScalar: result = (lhs *= x); break;
+      case TraceOp::DivideAssignScalar: result = (lhs /= x); break;
+      case TraceOp::Add: result = lhs + rhs; break;
+      case TraceOp::Subtract: result = lhs - rhs; break;
+      case TraceOp::Multiply: result = lhs * rhs; break;
+      case TraceOp::Divide: result = lhs / rhs; break;
+      case TraceOp::AddScalar: result = lhs + x; break;
+      case TraceOp::SubtractScalar: result = lhs - x; break;
+      case TraceOp::MultiplyScalar: result = lhs * x; break;
+      case TraceOp::DivideScalar: result = lhs / x; break;
+      case TraceOp::ScalarAdd: result = x + lhs; break;
+      case TraceOp::ScalarSubtract: result = x - lhs; break;
+      case TraceOp::ScalarMultiply: result = x * lhs; break;
+      case TraceOp::ScalarDivide: result = x / lhs; break;
+      case TraceOp::Equal: return lhs == rhs;
+      case TraceOp::NotEqual: return lhs != rhs;
+      case TraceOp::PreIncrement: result = ++lhs; break;
+      case TraceOp::PreDecrement: result = --lhs; break;
+      case TraceOp::PostIncrement: result = lhs++; break;
+      case TraceOp::PostDecrement: result = lhs--; break;
+      case TraceOp::UnaryPlus: result = +lhs; break;
+      case TraceOp::UnaryMinus: result = -lhs; break;
+      case TraceOp::Inverse: result = lhs.inverse(); break;
+      case TraceOp::TryInverse: return lhs.tryInverse(result) ? result[0] : 0;
+      case TraceOp::Transpose: result = lhs.transpose(); break;
+      case TraceOp::Determinant: return lhs.determinant();
+      case TraceOp::PreciseDeterminant: return lhs.preciseDeterminant();
+      case TraceOp::Discriminant: return lhs.discriminant();
+      case TraceOp::Trace: return lhs.trace();
+      case TraceOp::IsSymmetric: return lhs.isSymmetric();
+      case TraceOp::IsSimilar: return lhs.isSimilar(rhs);
+      case TraceOp::Eigenvalue: return lhs(record.argument).front();
+      case TraceOp::DeterminantCall: return lhs();
+      case TraceOp::Subscript: return lhs[record.argument];
+      case TraceOp::ConstSubscript: return record.lhs[record.argument];
+      case TraceOp::Output:{
+        ostringstream out;
+        out << lhs;
+        return (double) out.str().size();
+      }
+      case TraceOp::Input:{
+        istringstream in(input);
+        in >> lhs;
+        return lhs.trace();
+      }
+      default: throw invalid_argument("invalid argument");
+    }
+    return result[0];
+  }
+
+  // returns the time of an empty timed region, which is subtracted from every replay time
+  uint64_t clockOverhead(){
+    uint64_t best = numeric_limits<uint64_t>::max();
+    for(int i = 0; i < 1000; i++){
+      chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      best = min(best, elapsedNanoseconds(start, chrono::steady_clock::now()));
+    }
+    return best;
+  }
+
+  // the text operator>> reads back the recorded matrix from
+  string inputText(const Mat2x2 &mat){
+    double elements[4];
+    mat.getElements(elements);
+    ostringstream text;
+    text << setprecision(numeric_limits<double>::max_digits10);
+    text << elements[0] << ' ' << elements[1] << ' ' << elements[2] << ' ' << elements[3];
+    return text.str();
+  }
+
+  // operator>> prints a prompt to cout, which is dropped while a replay holds this buffer
+  struct DiscardBuffer : streambuf{
+    int overflow(int c){
+      return traits_type::not_eof(c);
+    }
+  };
+
+  // points cout at a buffer and restores it when it goes out of scope
+  class CoutRedirect{
+    private:
+      streambuf *saved;
+    public:
+      explicit CoutRedirect(streambuf *buffer) : saved(cout.rdbuf(buffer)) {}
+      ~CoutRedirect(){
+        cout.rdbuf(saved);
+      }
+      CoutRedirect(const CoutRedirect &redirect)=delete;
+      CoutRedirect &operator=(const CoutRedirect &redirect)=delete;
+  };
+}
+
+//-----------------------------------------------
+/*
+* This function returns the kind of the second operand of an
+* operator, the first one is always a matrix.
+*/
+//-----------------------------------------------
+TraceOperand traceOperandOf(TraceOp op){
+  switch(op){
+    case TraceOp::AddAssign: case TraceOp::SubtractAssign: case TraceOp::MultiplyAssign: case TraceOp::DivideAssign:
+    case TraceOp::Add: case TraceOp::Subtract: case TraceOp::Multiply: case TraceOp::Divide:
+    case TraceOp::Equal: case TraceOp::NotEqual: case TraceOp::IsSimilar:
+      return TraceOperand::Matrix;
+    case TraceOp::AddAssignScalar: case TraceOp::SubtractAssignScalar:
+    case TraceOp::MultiplyAssignScalar: case TraceOp::DivideAssignScalar:
+    case TraceOp::AddScalar: case TraceOp::SubtractScalar: case TraceOp::MultiplyScalar: case TraceOp::DivideScalar:
+    case TraceOp::ScalarAdd: case TraceOp::ScalarSubtract: case TraceOp::ScalarMultiply: case TraceOp::ScalarDivide:
+      return TraceOperand::Scalar;
+    case TraceOp::Eigenvalue: case TraceOp::Subscript: case TraceOp::ConstSubscript:
+      return TraceOperand::Integer;
+    default:
+      return TraceOperand::None;
+  }
+}
+
+const char *traceOpName(TraceOp op){
+  if(op >= TraceOp::Count){
+    throw invalid_argument("invalid argument");
+  }
+  return opNames[(size_t) op];
+}
+
+//-----------------------------------------------
+/*
+* Constructor and destructor for the recorder, which is a
+* single instance shared by every thread.
+*/
+//-----------------------------------------------
+TraceRecorder::TraceRecorder() : recording(false), file(NULL) {}
+
+TraceRecorder::~TraceRecorder(){
+  stop();
+}
+
+TraceRecorder &TraceRecorder::instance(){
+  static TraceRecorder recorder;
+  return recorder;
+}
+
+//-----------------------------------------------
+/*
+* This function starts a new trace file, a recording which
+* is in progress is stopped first. It throws runtime_error
+* if the file can't be created.
+*/
+//-----------------------------------------------
+void TraceRecorder::start(const string &path){
+  stop();
+  lock_guard<mutex> guard(lock);
+  file = fopen(path.c_str(), "wb");
+  if(file == NULL){
+    throw runtime_error("Trace file can't be created");
+  }
+  buffer.assign(traceMagic, traceMagic + sizeof(traceMagic));
+  recording = true;
+}
+
+void TraceRecorder::stop(){
+  lock_guard<mutex> guard(lock);
+  if(file == NULL){
+    return;
+  }
+  recording = false;
+  flush();
+  fclose(file);
+  file = NULL;
+}
+
+bool TraceRecorder::isRecording() const{
+  return recording.load(memory_order_relaxed);
+}
+
+// writes the buffer to the file, the lock must be held
+void TraceRecorder::flush(){
+  fwrite(buffer.data(), 1, buffer.size(), file);
+  buffer.clear();
+}
+
+//-----------------------------------------------
+/*
+* This function appends one record to the trace, records
+* which arrive after stop() are dropped.
+*/
+//-----------------------------------------------
+void TraceRecorder::record(const TraceRecord &record){
+  char bytes[1 + sizeof(uint32_t) + 2 * matrixBytes];
+  size_t size = 0;
+  bytes[size++] = (char) record.op;
+  memcpy(bytes + size, &record.nanoseconds, sizeof(uint32_t));
+  size += sizeof(uint32_t);
+  double elements[4];
+  record.lhs.getElements(elements);
+  memcpy(bytes + size, elements, matrixBytes);
+  size += matrixBytes;
+  switch(traceOperandOf(record.op)){
+    case TraceOperand::Matrix:
+      record.rhs.getElements(elements);
+      memcpy(bytes + size, elements, matrixBytes);
+      break;
+    case TraceOperand::Scalar:
+      memcpy(bytes + size, &record.scalar, sizeof(double));
+      break;
+    case TraceOperand::Integer:{
+      int32_t argument = record.argument;
+      memcpy(bytes + size, &argument, sizeof(int32_t));
+      break;
+    }
+    default:
+      break;
+  }
+  size += operandBytes(record.op);
+  lock_guard<mutex> guard(lock);
+  if(file == NULL){
+    return;
+  }
+  buffer.insert(buffer.end(), bytes, bytes + size);
+  if(buffer.size() >= bufferBytes){
+    flush();
+  }
+}
+
+//-----------------------------------------------
+/*
+* Constructors for the scope, one per kind of second
+* operand. Only the outermost scope of a thread records.
+*/
+//-----------------------------------------------
+TraceScope::TraceScope(TraceOp op, const Mat2x2 &lhs) : active(false) {
+  begin(op, lhs);
+}
+
+TraceScope::TraceScope(TraceOp op, const Mat2x2 &lhs, const Mat2x2 &rhs) : active(false) {
+  record.rhs = rhs;
+  begin(op, lhs);
+}
+
+TraceScope::TraceScope(TraceOp op, const Mat2x2 &lhs, double scalar) : active(false) {
+  record.scalar = scalar;
+  begin(op, lhs);
+}
+
+TraceScope::TraceScope(TraceOp op, const Mat2x2 &lhs, int argument) : active(false) {
+  record.argument = argument;
+  begin(op, lhs);
+}
+
+void TraceScope::begin(TraceOp op, const Mat2x2 &lhs){
+  if(depth++ > 0 || !TraceRecorder::instance().isRecording()){
+    return;
+  }
+  active = true;
+  record.op = op;
+  record.lhs = lhs;
+  start = chrono::steady_clock::now();
+}
+
+void TraceScope::setOperand(const Mat2x2 &lhs){
+  record.lhs = lhs;
+}
+
+TraceScope::~TraceScope(){
+  depth--;
+  if(!active){
+    return;
+  }
+  uint64_t elapsed = elapsedNanoseconds(start, chrono::steady_clock::now());
+  record.nanoseconds = (uint32_t) min<uint64_t>(elapsed, numeric_limits<uint32_t>::max());
+  TraceRecorder::instance().record(record);
+}
+
+//-----------------------------------------------
+/*
+* This function reads every record of a trace file, it throws
+* runtime_error if the file can't be opened, doesn't start
+* with the magic bytes or ends in the middle of a record.
+*/
+//-----------------------------------------------
+vector<TraceRecord> readTrace(const string &path){
+  FILE *file = fopen(path.c_str(), "rb");
+  if(file == NULL){
+    throw runtime_error("Trace file can't be opened");
+  }
+  vector<char> bytes;
+  char chunk[bufferBytes];
+  size_t read;
+  while((read = fread(chunk, 1, sizeof(chunk), file)) > 0){
+    bytes.insert(bytes.end(), chunk, chunk + read);
+  }
+  fclose(file);
+  if(bytes.size() < sizeof(traceMagic) || memcmp(bytes.data(), traceMagic, sizeof(traceMagic)) != 0){
+    throw runtime_error("Invalid trace");
+  }
+  vector<TraceRecord> records;
+  size_t position = sizeof(traceMagic);
+  while(position < bytes.size()){
+    TraceRecord record = TraceRecord();
+    record.op = (TraceOp) (uint8_t) bytes[position];
+    if(record.op >= TraceOp::Count || bytes.size() - position < 1 + sizeof(uint32_t) + matrixBytes + operandBytes(record.op)){
+      throw runtime_error("Invalid trace");
+    }
+    const char *src = bytes.data() + position + 1;
+    memcpy(&record.nanoseconds, src, sizeof(uint32_t));
+    src += sizeof(uint32_t);
+    double elements[4];
+    memcpy(elements, src, matrixBytes);
+    record.lhs.setElements(elements);
+    src += matrixBytes;
+    switch(traceOperandOf(record.op)){
+      case TraceOperand::Matrix:
+        memcpy(elements, src, matrixBytes);
+        record.rhs.setElements(elements);
+        break;
+      case TraceOperand::Scalar:
+        memcpy(&record.scalar, src, sizeof(double));
+        break;
+      case TraceOperand::Integer:{
+        int32_t argument;
+        memcpy(&argument, src, sizeof(int32_t));
+        record.argument = argument;
+        break;
+      }
+      default:
+        break;
+    }
+    position += 1 + sizeof(uint32_t) + matrixBytes + operandBytes(record.op);
+    records.push_back(record);
+  }
+  return records;
+}
+
+//-----------------------------------------------
+/*
+* This function executes the records repeat times, in their
+* recorded order or grouped by operator. The sequence runs in
+* windows of up to replayWindow consecutive records, a grouped
+* window doesn't cross to the next operator, and each window is
+* timed as a whole, because a clock read costs about as much as
+* the operations. The time of an empty timed region is
+* subtracted from every window, and the rest is shared between
+* the records of the window in proportion to their recorded
+* times plus 1 ns, so a window of ops which were recorded as
+* equally fast is split evenly. Exceptions, e.g the inverse of
+* a singular matrix, are counted and the replay goes on, their
+* cost is part of the time of their window.
+*/
+//-----------------------------------------------
+vector<TraceOpStats> replayTrace(const vector<TraceRecord> &records, size_t repeat, TraceReplay replay){
+  vector<TraceOpStats> stats((size_t) TraceOp::Count);
+  for(size_t i = 0; i < stats.size(); i++){
+    stats[i].minNanoseconds = numeric_limits<uint64_t>::max();
+  }
+  vector<size_t> sequence(records.size());
+  vector<string> inputs(records.size());
+  for(size_t i = 0; i < records.size(); i++){
+    sequence[i] = i;
+    if(records[i].op == TraceOp::Input){
+      inputs[i] = inputText(records[i].lhs);
+    }
+  }
+  if(replay == TraceReplay::GroupByOperator){
+    stable_sort(sequence.begin(), sequence.end(), [&records](size_t x, size_t y){ return records[x].op < records[y].op; });
+  }
+  vector<double> windowTime(stats.size());
+  vector<size_t> windowCount(stats.size());
+  DiscardBuffer discard;
+  CoutRedirect redirect(&discard);
+  uint64_t overhead = clockOverhead();
+  volatile double sink = 0;
+  for(size_t round = 0; round < repeat; round++){
+    size_t last;
+    for(size_t first = 0; first < sequence.size(); first = last){
+      TraceOp firstOp = records[sequence[first]].op;
+      last = first + 1;
+      while(last < sequence.size() && last - first < replayWindow &&
+            (replay == TraceReplay::InOrder || records[sequence[last]].op == firstOp)){
+        last++;
+      }
+      chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      for(size_t k = first; k < last; k++){
+        try{
+          sink = sink + execute(records[sequence[k]], inputs[sequence[k]]);
+        }
+        catch(const exception &){
+          stats[(size_t) records[sequence[k]].op].exceptions++;
+        }
+      }
+      uint64_t elapsed = elapsedNanoseconds(start, chrono::steady_clock::now());
+      elapsed = elapsed > overhead ? elapsed - overhead : 0;
+
+      double weights = 0;
+      for(size_t k = first; k < last; k++){
+        weights += (double) records[sequence[k]].nanoseconds + 1;
+      }
+      for(size_t k = first; k < last; k++){
+        const TraceRecord &record = records[sequence[k]];
+        TraceOpStats &entry = stats[(size_t) record.op];
+        entry.count++;
+        entry.recordedNanoseconds += record.nanoseconds;
+        windowTime[(size_t) record.op] += elapsed * (((double) record.nanoseconds + 1) / weights);
+        windowCount[(size_t) record.op]++;
+      }
+      for(size_t k = first; k < last; k++){
+        size_t op = (size_t) records[sequence[k]].op;
+        if(windowCount[op] == 0){
+          continue;
+        }
+        TraceOpStats &entry = stats[op];
+        uint64_t share = (uint64_t) (windowTime[op] + 0.5);
+        entry.replayNanoseconds += share;
+        entry.minNanoseconds = min(entry.minNanoseconds, share / windowCount[op]);
+        entry.maxNanoseconds = max(entry.maxNanoseconds, share / windowCount[op]);
+        windowTime[op] = 0;
+        windowCount[op] = 0;
+      }
+    }
+  }
+  for(size_t i = 0; i < stats.size(); i++){
+    if(stats[i].count == 0){
+      stats[i].minNanoseconds = 0;
+    }
+  }
+  return stats;
+}
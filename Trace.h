@@ -0,0 +1,152 @@
+//-----------------------------------------------
+/**
+* This is the header file for the recording and replay of the
+* Mat2x2 operations a program performs.
+*
+* When Mat2x2.cpp is compiled with -DMAT2X2_TRACE every public
+* operation opens a TraceScope, which times it and, while the
+* TraceRecorder is recording, appends the operator, the
+* operands and the time to a binary trace file. Without the
+* flag Mat2x2.cpp doesn't include this header and the scopes
+* compile to nothing. Operators which call other operators,
+* e.g operator* which uses *=, are recorded once as the
+* outermost operator, a thread_local depth keeps the inner
+* ones out of the trace.
+*
+* The trace file starts with the 8 bytes "M2X2TRC1" followed
+* by one record per operation in the byte order of the host:
+*
+* op           1 byte
+* nanoseconds  4 bytes, saturated
+* lhs          4 doubles
+* rhs          4 doubles, 1 double or 1 int, or nothing, by op
+*
+* operator>> records the matrix it has read, which replay parses
+* again from text, operator<< records the matrix it prints.
+*
+* readTrace() loads a trace and replayTrace() executes it again
+* as fast as it can and returns the statistics per operator next
+* to the recorded times. By default the records run in their
+* recorded order, so the caches and the branch predictor see the
+* sequence of the program. A single operation takes a few ns,
+* about as long as reading the clock, so the replay times windows
+* of consecutive records and shares the time of a window between
+* its records in proportion to their recorded times. Those
+* include the cost of recording, so the cheapest operators get
+* more than their own cost, the total of a window is exact.
+* With TraceReplay::GroupByOperator the records of each operator
+* run together instead, which gives the cost of an operator
+* alone but isn't a re-execution of the program.
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+#ifndef TRACE_H
+#define TRACE_H
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Mat2x2.h"
+
+enum class TraceOp : uint8_t{
+  AddAssign, SubtractAssign, MultiplyAssign, DivideAssign, // mat op= mat
+  AddAssignScalar, SubtractAssignScalar, MultiplyAssignScalar, DivideAssignScalar, // mat op= x
+  Add, Subtract, Multiply, Divide, // mat op mat
+  AddScalar, SubtractScalar, MultiplyScalar, DivideScalar, // mat op x
+  ScalarAdd, ScalarSubtract, ScalarMultiply, ScalarDivide, // x op mat
+  Equal, NotEqual,
+  PreIncrement, PreDecrement, PostIncrement, PostDecrement, UnaryPlus, UnaryMinus,
+  Inverse, TryInverse, Transpose, Determinant, PreciseDeterminant, Discriminant, Trace,
+  IsSymmetric, IsSimilar,
+  Eigenvalue, // operator()(int)
+  DeterminantCall, // operator()()
+  Subscript, ConstSubscript, // operator[](int) and operator[](int) const
+  Output, Input, // operator<< and operator>>
+  Count // number of operators, not an operator
+};
+
+enum class TraceOperand : uint8_t{
+  None, Matrix, Scalar, Integer
+};
+
+TraceOperand traceOperandOf(TraceOp op); // kind of the second operand of op
+const char *traceOpName(TraceOp op);
+
+struct TraceRecord{
+  TraceOp op;
+  uint32_t nanoseconds;
+  Mat2x2 lhs;
+  Mat2x2 rhs; // for TraceOperand::Matrix
+  double scalar; // for TraceOperand::Scalar
+  int argument; // for TraceOperand::Integer
+};
+
+class TraceRecorder{
+  private:
+    std::mutex lock;
+    std::atomic<bool> recording;
+    std::FILE *file;
+    std::vector<char> buffer;
+    TraceRecorder();
+    void flush();
+  public:
+    ~TraceRecorder(); // dtor, stops the recording
+    TraceRecorder(const TraceRecorder &recorder)=delete;
+    TraceRecorder &operator=(const TraceRecorder &recorder)=delete;
+
+    static TraceRecorder &instance();
+
+    void start(const std::string &path); // stops any recording and starts a new trace file
+    void stop(); // writes the rest of the trace and closes the file
+    bool isRecording() const;
+    void record(const TraceRecord &record);
+};
+
+class TraceScope{
+  private:
+    bool active;
+    TraceRecord record;
+    std::chrono::steady_clock::time_point start;
+    void begin(TraceOp op, const Mat2x2 &lhs);
+  public:
+    TraceScope(TraceOp op, const Mat2x2 &lhs);
+    TraceScope(TraceOp op, const Mat2x2 &lhs, const Mat2x2 &rhs);
+    TraceScope(TraceOp op, const Mat2x2 &lhs, double scalar);
+    TraceScope(TraceOp op, const Mat2x2 &lhs, int argument);
+    ~TraceScope(); // dtor, records the operation with its time
+    void setOperand(const Mat2x2 &lhs); // replaces lhs, for operators which produce the matrix, i.e operator>>
+    TraceScope(const TraceScope &scope)=delete;
+    TraceScope &operator=(const TraceScope &scope)=delete;
+};
+
+// used by Mat2x2.cpp, which defines them as nothing without MAT2X2_TRACE
+#define MAT2X2_TRACE_SCOPE(...) TraceScope traceScope(__VA_ARGS__)
+#define MAT2X2_TRACE_OPERAND(mat) traceScope.setOperand(mat)
+
+struct TraceOpStats{
+  size_t count;
+  size_t exceptions; // operations which threw during the replay
+  uint64_t recordedNanoseconds; // sum of the recorded times
+  uint64_t replayNanoseconds; // sum of the replay times
+  uint64_t minNanoseconds, maxNanoseconds; // of the replay, per operation averaged over its records in a window
+};
+
+enum class TraceReplay : uint8_t{
+  InOrder, // the records in their recorded order
+  GroupByOperator // the records of each operator together, in their order
+};
+
+// throws runtime_error if the file can't be read or isn't a valid trace
+std::vector<TraceRecord> readTrace(const std::string &path);
+
+// executes every record repeat times in timed windows of consecutive records, the result is indexed by TraceOp
+std::vector<TraceOpStats> replayTrace(const std::vector<TraceRecord> &records, size_t repeat = 1,
+                                      TraceReplay replay = TraceReplay::InOrder);
+#endif
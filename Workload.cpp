@@ -0,0 +1,102 @@
+//-----------------------------------------------
+/**
+* This is the implementation file for Mat2x2Generator class.
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+
+#include <cmath>
+#include <stdexcept>
+#include "Workload.h"
+
+using namespace std;
+
+Mat2x2Generator::Mat2x2Generator(uint64_t seed, double range1, double gap1) : engine(seed), range(range1), gap(gap1) {
+  if(!(range > 0) || !(gap > 0)){
+    throw invalid_argument("invalid argument");
+  }
+}
+
+// the top 53 bits of the engine output scaled to [0, 1)
+double Mat2x2Generator::unit(){
+  return (double) (engine() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+double Mat2x2Generator::element(){
+  return range * ((2 * unit()) - 1);
+}
+
+//-----------------------------------------------
+/*
+* This function returns one matrix of the given kind. The
+* factor of a Singular matrix is a power of two, so
+* a * (k*b) and b * (k*a) round to the same value and the
+* determinant is exactly zero.
+*/
+//-----------------------------------------------
+Mat2x2 Mat2x2Generator::next(MatrixKind kind){
+  switch(kind){
+    case MatrixKind::Uniform:{
+      double a = element(), b = element(), c = element();
+      return Mat2x2(a, b, c, element());
+    }
+    case MatrixKind::Symmetric:{
+      double a = element(), b = element();
+      return Mat2x2(a, b, b, element());
+    }
+    case MatrixKind::Singular:
+    case MatrixKind::NearSingular:{
+      double a = element(), b = element();
+      uint64_t bits = engine();
+      // disjoint bits for the sign, the layout and the power, (bits >> 2) % 7 is close to uniform and independent of both
+      double factor = ldexp((bits & 1) ? -1.0 : 1.0, (int) ((bits >> 2) % 7) - 3);
+      Mat2x2 temp = (bits & 2) ? Mat2x2(a, b, factor * a, factor * b) : Mat2x2(a, factor * a, b, factor * b);
+      if(kind == MatrixKind::NearSingular){
+        for(int i = 0; i < 4; i++){
+          temp[i] += gap * element();
+        }
+      }
+      return temp;
+    }
+    default:
+      throw invalid_argument("invalid argument");
+  }
+}
+
+//-----------------------------------------------
+/*
+* This function picks the kind of the next matrix with the
+* weights of mix, which must not all be zero.
+*/
+//-----------------------------------------------
+Mat2x2 Mat2x2Generator::next(const WorkloadMix &mix){
+  double total = mix.uniform + mix.singular + mix.symmetric + mix.nearSingular;
+  if(!(total > 0) || mix.uniform < 0 || mix.singular < 0 || mix.symmetric < 0 || mix.nearSingular < 0){
+    throw invalid_argument("invalid argument");
+  }
+  double pick = unit() * total;
+  if(pick < mix.uniform){
+    return next(MatrixKind::Uniform);
+  }
+  pick -= mix.uniform;
+  if(pick < mix.singular){
+    return next(MatrixKind::Singular);
+  }
+  pick -= mix.singular;
+  if(pick < mix.symmetric || mix.nearSingular == 0){
+    return next(MatrixKind::Symmetric);
+  }
+  return next(MatrixKind::NearSingular);
+}
+
+vector<Mat2x2> Mat2x2Generator::generate(size_t count, const WorkloadMix &mix){
+  vector<Mat2x2> temp;
+  temp.reserve(count);
+  for(size_t i = 0; i < count; i++){
+    temp.push_back(next(mix));
+  }
+  return temp;
+}
@@ -0,0 +1,60 @@
+//-----------------------------------------------
+/**
+* This is the header file for Mat2x2Generator class, a seeded
+* generator of synthetic Mat2x2 workloads for benchmarks and
+* for reproducing a trace without the original service.
+*
+* The kinds of matrices it generates are
+*
+* Uniform       every element uniform in [-range, range]
+* Singular      one row (or column) is the other one times
+*               +-2^k, k in [-3, 3], so a*d - b*c is exactly 0
+* Symmetric     b = c
+* NearSingular  a Singular matrix plus a uniform perturbation
+*               of gap * range on every element
+*
+* and a WorkloadMix picks the kind of every matrix with the
+* given weights. The elements are built from the raw 64 bit
+* output of std::mt19937_64, which is fixed by the standard,
+* and not from the std distributions, which aren't, so a seed
+* gives the same matrices with every compiler and library.
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "Mat2x2.h"
+
+enum class MatrixKind{
+  Uniform, Singular, Symmetric, NearSingular
+};
+
+struct WorkloadMix{
+  double uniform, singular, symmetric, nearSingular; // weights, they don't have to sum to 1
+
+  WorkloadMix(double uniform1 = 0.7, double singular1 = 0.1, double symmetric1 = 0.1, double nearSingular1 = 0.1)
+    : uniform(uniform1), singular(singular1), symmetric(symmetric1), nearSingular(nearSingular1) {}
+};
+
+class Mat2x2Generator{
+  private:
+    std::mt19937_64 engine;
+    double range, gap;
+    double unit(); // uniform in [0, 1)
+    double element(); // uniform in [-range, range]
+  public:
+    // ctor, it throws invalid_argument error if range or gap isn't positive
+    explicit Mat2x2Generator(uint64_t seed, double range = 1, double gap = 1.e-9);
+
+    Mat2x2 next(MatrixKind kind);
+    Mat2x2 next(const WorkloadMix &mix = WorkloadMix());
+    std::vector<Mat2x2> generate(size_t count, const WorkloadMix &mix = WorkloadMix());
+};
+#endif
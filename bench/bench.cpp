@@ -0,0 +1,661 @@
+//-----------------------------------------------
+/**
+* This is the benchmark driver for the Mat2x2 library. It
+* lives outside the root directory so it isn't linked into
+* the test driver, build it from the root directory with
+*
+* g++ -std=c++11 -O3 -march=native -pthread -I. bench/bench.cpp \
+*     $(ls *.cpp | grep -v driver.cpp) -o mat2x2bench
+*
+* and run "mat2x2bench <name>" for one benchmark or
+* "mat2x2bench" for all of them. Every benchmark prints the
+* best of a few repetitions, so the numbers are comparable
+* between runs on the same machine.
+*
+* @author  Matrix2x2-ADT contributors
+* @version 1.0
+* @since   2026-10-18
+*/
+//-----------------------------------------------
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+#include "BlockTridiagonal.h"
+#include "Decomposition.h"
+#include "Mat2x2.h"
+#include "Mat2x2Batch.h"
+#include "Mat2x2Tiles.h"
+#include "MarkovChain.h"
+#include "MemoCache.h"
+#include "Parallel.h"
+#include "SlidingWindow.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+namespace {
+  const int repetitions = 5;
+
+  // keeps the compiler from dropping the benchmarked work
+  volatile double sink;
+
+  //-----------------------------------------------
+  /*
+  * This is a helper method which returns the best time of
+  * fn in seconds over the repetitions.
+  */
+  //-----------------------------------------------
+  double bestOf(const function<void()> &fn){
+    double best = 1e300;
+    for(int i = 0; i < repetitions; i++){
+      chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      fn();
+      chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+      best = min(best, elapsed.count());
+    }
+    return best;
+  }
+
+  vector<Mat2x2> sampleMatrices(size_t count){
+    vector<Mat2x2> mats;
+    mats.reserve(count);
+    for(size_t i = 0; i < count; i++){
+      double x = (double) (i % 1000) / 1000;
+      mats.push_back(Mat2x2(2 + x, 1 - x, x, 3 - x));
+    }
+    return mats;
+  }
+
+  //-----------------------------------------------
+  /*
+  * This benchmark runs parallelTransform over 4M matrices on
+  * pools of 1 to 64 threads and prints the speedup over one
+  * thread. Counts above the number of cpus oversubscribe
+  * the machine and show the cost of that.
+  */
+  //-----------------------------------------------
+  void benchThreadPool(){
+    vector<Mat2x2> in = sampleMatrices(1 << 22), out;
+    printf("threadpool: parallelTransform of %zu inverses, %zu cpus\n", in.size(), ThreadPool::defaultThreadCount());
+    printf("%8s %12s %10s\n", "threads", "ms", "speedup");
+    double base = 0;
+    for(size_t threads = 1; threads <= 64; threads *= 2){
+      ThreadPool pool(threads);
+      double seconds = bestOf([&]{
+        parallelTransform(pool, in, out, 0, [](const Mat2x2 &mat){ return mat.inverse(); });
+        sink = out[in.size() / 2][0];
+      });
+      base = threads == 1 ? seconds : base;
+      printf("%8zu %12.2f %10.2f\n", threads, seconds * 1e3, base / seconds);
+    }
+  }
+
+  //-----------------------------------------------
+  /*
+  * This is a helper method which returns the best time in ns
+  * per call of fn over every matrix of calls.
+  */
+  //-----------------------------------------------
+  template <typename Function>
+  double nsPerCall(const vector<Mat2x2> &calls, Function fn){
+    return bestOf([&]{
+      double sum = 0;
+      for(size_t i = 0; i < calls.size(); i++){
+        sum += fn(calls[i]);
+      }
+      sink = sum;
+    }) * 1e9 / calls.size();
+  }
+
+  //-----------------------------------------------
+  /*
+  * This benchmark compares the Mat2x2 operations with a hit
+  * of Mat2x2MemoCache, 1M calls over working sets of 64 to
+  * 4096 distinct matrices which all fit in the cache. A
+  * cached operation only pays off if it costs more than the
+  * hit.
+  */
+  //-----------------------------------------------
+  void benchMemoCache(){
+    printf("memo: 1M calls, ns per call\n");
+    printf("%8s %12s %10s %11s %8s %8s %10s\n", "matrices", "determinant", "inverse", "eigenvalue", "svd", "polar", "cache hit");
+    for(size_t distinct = 64; distinct <= 4096; distinct *= 8){
+      vector<Mat2x2> mats = sampleMatrices(distinct);
+      for(size_t i = 0; i < mats.size(); i++){
+        mats[i][1] += (double) i / distinct;
+      }
+      vector<Mat2x2> calls;
+      for(size_t i = 0; i < (1 << 20); i++){
+        calls.push_back(mats[(i * 2654435761u) % distinct]);
+      }
+      Mat2x2MemoCache<double> cache(2 * distinct);
+      printf("%8zu %12.1f %10.1f %11.1f %8.1f %8.1f %10.1f\n", distinct,
+             nsPerCall(calls, [](const Mat2x2 &mat){ return (double) mat.determinant(); }),
+             nsPerCall(calls, [](const Mat2x2 &mat){ return mat.inverse()[0]; }),
+             nsPerCall(calls, [](const Mat2x2 &mat){ Mat2x2 temp = mat; return temp(1)[0]; }),
+             nsPerCall(calls, [](const Mat2x2 &mat){ return svd(mat).sigma1; }),
+             nsPerCall(calls, [](const Mat2x2 &mat){ return polar(mat).orthogonal[0]; }),
+             nsPerCall(calls, [&cache](const Mat2x2 &mat){
+               return cache.getOrCompute(mat, [](const Mat2x2 &m){ return m[0]; });
+             }));
+    }
+  }
+
+  //-----------------------------------------------
+  /*
+  * This is a helper method which returns the largest error of
+  * the float results against the double ones. Every group of
+  * width elements is one result, the error of an element is
+  * relative to the largest element of its group in the double
+  * result.
+  */
+  //-----------------------------------------------
+  double maxError(const vector<const double *> &exact, const vector<const float *> &approx, size_t count){
+    double worst = 0;
+    for(size_t i = 0; i < count; i++){
+      double scale = 0;
+      for(size_t k = 0; k < exact.size(); k++){
+        scale = max(scale, fabs(exact[k][i]));
+      }
+      for(size_t k = 0; k < exact.size() && scale > 0; k++){
+        worst = max(worst, fabs(exact[k][i] - (double) approx[k][i]) / scale);
+      }
+    }
+    return worst;
+  }
+
+  //-----------------------------------------------
+  /*
+  * This benchmark times the batch kernels on count random
+  * matrices with elements in [-1, 1] which are exact in float,
+  * 2^12 matrices stay in the L2 cache and 2^20 don't.
+  * "loop" is a loop of the Mat2x2 operation over a
+  * vector<Mat2x2>, the other columns are ns per matrix of the
+  * double kernel, and the error and speedup of the float
+  * kernels against it. These are the numbers in the table of
+  * Mat2x2Batch.h.
+  */
+  //-----------------------------------------------
+  void benchBatch(size_t count){
+    mt19937_64 engine(2026);
+    uniform_real_distribution<float> element(-1, 1);
+    vector<Mat2x2> lhsMats, rhsMats;
+    for(size_t i = 0; i < count; i++){
+      lhsMats.push_back(Mat2x2(element(engine), element(engine), element(engine), element(engine)));
+      rhsMats.push_back(Mat2x2(element(engine), element(engine), element(engine), element(engine)));
+    }
+    Mat2x2Batch<double> lhs(lhsMats), rhs(rhsMats), out(count);
+    Mat2x2Batch<float> lhsFloat(lhsMats), rhsFloat(rhsMats), outFloat(count), outMixed(count);
+    vector<double> det(count);
+    vector<float> detFloat(count), detMixed(count);
+    vector<Mat2x2> loopOut(count);
+    Mat2x2BatchView<const double> exact = out.view();
+    vector<const double *> exactElements = {exact.a, exact.b, exact.c, exact.d};
+    Mat2x2BatchView<const float> storage = outFloat.view(), mixed = outMixed.view();
+    vector<const float *> storageElements = {storage.a, storage.b, storage.c, storage.d};
+    vector<const float *> mixedElements = {mixed.a, mixed.b, mixed.c, mixed.d};
+    double perMatrix = 1e9 / count;
+
+    printf("batch: %zu matrices, ns per matrix, float error and speedup against the double kernel\n", count);
+    printf("%12s %8s %8s %20s %24s\n", "operator", "loop", "double", "float", "float + Accumulate::Double");
+
+    double loop = bestOf([&]{
+      for(size_t i = 0; i < count; i++){
+        loopOut[i] = lhsMats[i] * rhsMats[i];
+      }
+    });
+    double kernel = bestOf([&]{ batchMultiply(lhs.view(), rhs.view(), out.view()); });
+    double single = bestOf([&]{ batchMultiply(lhsFloat.view(), rhsFloat.view(), outFloat.view()); });
+    double accumulated = bestOf([&]{ batchMultiply(lhsFloat.view(), rhsFloat.view(), outMixed.view(), Accumulate::Double); });
+    printf("%12s %8.2f %8.2f %12.1e, %5.1fx %16.1e, %5.1fx\n", "multiply", loop * perMatrix, kernel * perMatrix,
+           maxError(exactElements, storageElements, count), kernel / single,
+           maxError(exactElements, mixedElements, count), kernel / accumulated);
+
+    loop = bestOf([&]{
+      double sum = 0;
+      for(size_t i = 0; i < count; i++){
+        sum += lhsMats[i].preciseDeterminant();
+      }
+      sink = sum;
+    });
+    kernel = bestOf([&]{ batchDeterminant(lhs.view(), det.data()); });
+    single = bestOf([&]{ batchDeterminant(lhsFloat.view(), detFloat.data()); });
+    accumulated = bestOf([&]{ batchDeterminant(lhsFloat.view(), detMixed.data(), Accumulate::Double); });
+    vector<const double *> exactDet = {det.data()};
+    vector<const float *> singleDet = {detFloat.data()}, mixedDet = {detMixed.data()};
+    printf("%12s %8.2f %8.2f %12.1e, %5.1fx %16.1e, %5.1fx\n", "determinant", loop * perMatrix, kernel * perMatrix,
+           maxError(exactDet, singleDet, count), kernel / single, maxError(exactDet, mixedDet, count), kernel / accumulated);
+
+    // the compensated kernels have no float form, their rows sit beside the plain double determinant above
+    kernel = bestOf([&]{ batchPreciseDeterminant(lhs.view(), det.data()); });
+    printf("%12s %8.2f %8.2f %20s %24s\n", "precise det", loop * perMatrix, kernel * perMatrix, "-", "-");
+
+    loop = bestOf([&]{
+      double sum = 0;
+      for(size_t i = 0; i < count; i++){
+        sum += lhsMats[i].discriminant();
+      }
+      sink = sum;
+    });
+    kernel = bestOf([&]{ batchDiscriminant(lhs.view(), det.data()); });
+    printf("%12s %8.2f %8.2f %20s %24s\n", "discriminant", loop * perMatrix, kernel * perMatrix, "-", "-");
+
+    loop = bestOf([&]{
+      for(size_t i = 0; i < count; i++){
+        lhsMats[i].tryInverse(loopOut[i]);
+      }
+    });
+    kernel = bestOf([&]{ batchInverse(lhs.view(), out.view()); });
+    single = bestOf([&]{ batchInverse(lhsFloat.view(), outFloat.view()); });
+    accumulated = bestOf([&]{ batchInverse(lhsFloat.view(), outMixed.view(), Accumulate::Double); });
+    printf("%12s %8.2f %8.2f %12.1e, %5.1fx %16.1e, %5.1fx\n", "inverse", loop * perMatrix, kernel * perMatrix,
+           maxError(exactElements, storageElements, count), kernel / single,
+           maxError(exactElements, mixedElements, count), kernel / accumulated);
+
+    loop = bestOf([&]{
+      for(size_t i = 0; i < count; i++){
+        loopOut[i] = lhsMats[i].transpose();
+      }
+    });
+    kernel = bestOf([&]{ batchTranspose(lhs.view(), out.view()); });
+    single = bestOf([&]{ batchTranspose(lhsFloat.view(), outFloat.view()); });
+    printf("%12s %8.2f %8.2f %12.1e, %5.1fx %24s\n", "transpose", loop * perMatrix, kernel * perMatrix,
+           maxError(exactElements, storageElements, count), kernel / single, "-");
+    sink = loopOut[count / 2][0];
+  }
+
+  void benchBatch(){
+    benchBatch(1 << 12);
+    benchBatch(1 << 20);
+  }
+
+#if defined(__SIZEOF_FLOAT128__)
+  typedef __float128 Quad;
+
+  Quad quadSqrt(Quad x){
+    if(x <= 0){
+      return 0;
+    }
+    Quad root = sqrt((double) x);
+    root = (root + (x / root)) / 2;
+    return (root + (x / root)) / 2;
+  }
+
+  Quad quadAbs(Quad x){
+    return x < 0 ? -x : x;
+  }
+
+  // largest |X^T * X - I| element in quad precision
+  Quad orthogonalError(const Mat2x2 &mat){
+    Quad a = mat[0], b = mat[1], c = mat[2], d = mat[3];
+    Quad errors[3] = {quadAbs((a * a) + (c * c) - 1), quadAbs((a * b) + (c * d)), quadAbs((b * b) + (d * d) - 1)};
+    return max(errors[0], max(errors[1], errors[2]));
+  }
+
+  // largest |lhs * rhs - mat| element in quad precision
+  Quad productError(const Mat2x2 &lhs, const Mat2x2 &rhs, const Mat2x2 &mat){
+    Quad worst = 0;
+    for(int row = 0; row < 2; row++){
+      for(int col = 0; col < 2; col++){
+        Quad sum = ((Quad) lhs[2 * row] * rhs[col]) + ((Quad) lhs[2 * row + 1] * rhs[2 + col]);
+        worst = max(worst, quadAbs(sum - mat[2 * row + col]));
+      }
+    }
+    return worst;
+  }
+
+  //-----------------------------------------------
+  /*
+  * This benchmark measures the accuracy of svd() and polar()
+  * against a __float128 reference, s1 = |(E, H)| + |(F, G)|
+  * and s2 = |a*d - b*c| / s1 (see Decomposition.cpp), over
+  * kinds of matrices which are hard for closed forms. Every
+  * error but "orthogonal" is relative to s1, "orthogonal" is
+  * the largest error of U^T * U, V^T * V and Q^T * Q against
+  * the identity,
+  * "S < 0" is how far the smallest eigenvalue of the polar S
+  * is below 0. These are the numbers in the table of
+  * Decomposition.h.
+  */
+  //-----------------------------------------------
+  void benchDecomposition(){
+    const size_t count = 1 << 18;
+    const char *kinds[] = {"random", "det < 0", "near rank one", "rank one", "near conformal", "near reflection"};
+    mt19937_64 engine(2026);
+    uniform_real_distribution<double> element(-1, 1);
+    uniform_int_distribution<int> small(-8, 8);
+    printf("decomposition: %zu matrices of each kind, largest error relative to s1 against __float128\n", count);
+    printf("%16s %9s %9s %11s %9s %9s %9s\n", "input", "s1", "s2", "orthogonal", "U*S*V^T", "Q*S", "S < 0");
+    for(int kind = 0; kind < 6; kind++){
+      Quad worst[6] = {0, 0, 0, 0, 0, 0};
+      for(size_t n = 0; n < count; n++){
+        double a = element(engine), b = element(engine), c = element(engine), d = element(engine);
+        if(kind == 1 && (a * d) - (b * c) >= 0){
+          swap(a, c);
+          swap(b, d);
+        }
+        else if(kind == 2 || kind == 3){
+          double u0 = kind == 2 ? a : small(engine) * 0.125, u1 = kind == 2 ? b : small(engine) * 0.125;
+          double v0 = kind == 2 ? c : small(engine) * 0.125, v1 = kind == 2 ? d : small(engine) * 0.125;
+          double noise = kind == 2 ? 1e-12 : 0;
+          a = (u0 * v0) + (noise * element(engine));
+          b = (u0 * v1) + (noise * element(engine));
+          c = (u1 * v0) + (noise * element(engine));
+          d = (u1 * v1) + (noise * element(engine));
+        }
+        else if(kind >= 4){
+          double angle = 3.14159265358979 * a, scale = 1 + b, stretch = scale * (1 + 1e-10);
+          double sign = kind == 5 ? -1 : 1; // a rotation or a reflection times diag(1, 1 + 1e-10)
+          a = scale * cos(angle);
+          b = -sign * stretch * sin(angle);
+          c = scale * sin(angle);
+          d = sign * stretch * cos(angle);
+        }
+        Mat2x2 mat(a, b, c, d);
+        Quad qa = a, qb = b, qc = c, qd = d;
+        Quad rotation = quadSqrt((((qa + qd) * (qa + qd)) + ((qc - qb) * (qc - qb))) / 4);
+        Quad reflection = quadSqrt((((qa - qd) * (qa - qd)) + ((qc + qb) * (qc + qb))) / 4);
+        Quad s1 = rotation + reflection;
+        if(s1 == 0){
+          continue;
+        }
+        Quad s2 = quadAbs((qa * qd) - (qb * qc)) / s1;
+        Mat2x2Svd usv = svd(mat);
+        Mat2x2Polar qs = polar(mat);
+        Mat2x2 us(usv.u[0] * usv.sigma1, usv.u[1] * usv.sigma2, usv.u[2] * usv.sigma1, usv.u[3] * usv.sigma2);
+        Quad s11 = qs.stretch[0], s12 = qs.stretch[1], s22 = qs.stretch[3];
+        Quad smallest = ((s11 + s22) / 2) - quadSqrt((((s11 - s22) * (s11 - s22)) / 4) + (s12 * s12));
+        Quad errors[6] = {quadAbs(usv.sigma1 - s1), quadAbs(usv.sigma2 - s2),
+                          max(orthogonalError(usv.u), max(orthogonalError(usv.v), orthogonalError(qs.orthogonal))),
+                          productError(us, usv.v.transpose(), mat), productError(qs.orthogonal, qs.stretch, mat),
+                          smallest < 0 ? -smallest : 0};
+        for(int k = 0; k < 6; k++){
+          worst[k] = max(worst[k], k == 2 ? errors[k] : errors[k] / s1);
+        }
+      }
+      printf("%16s %9.1e %9.1e %11.1e %9.1e %9.1e %9.1e\n", kinds[kind], (double) worst[0], (double) worst[1],
+             (double) worst[2], (double) worst[3], (double) worst[4], (double) worst[5]);
+    }
+  }
+#endif
+
+  //-----------------------------------------------
+  /*
+  * This is a helper method which solves a block tridiagonal
+  * system as a generic banded system of 2n scalar rows with 3
+  * sub- and 3 superdiagonals, stored by columns as LAPACK's
+  * dgbsv does, with partial pivoting, which widens the upper
+  * band to 6.
+  */
+  //-----------------------------------------------
+  vector<Vec2> solveBanded(const vector<Mat2x2> &lower, const vector<Mat2x2> &diag,
+                           const vector<Mat2x2> &upper, const vector<Vec2> &rhs){
+    const size_t kl = 3, ku = 3, rows = (2 * kl) + ku + 1;
+    size_t n = 2 * diag.size();
+    vector<double> band(rows * n, 0), b(n);
+    // element (i, j) of the matrix, for j - kl - ku <= i <= j + kl
+    auto at = [&](size_t i, size_t j) -> double & { return band[(j * rows) + kl + ku + i - j]; };
+    for(size_t i = 0; i < diag.size(); i++){
+      double l[4], d[4], u[4];
+      lower[i].getElements(l);
+      diag[i].getElements(d);
+      upper[i].getElements(u);
+      for(size_t r = 0; r < 2; r++){
+        for(size_t k = 0; k < 2; k++){
+          at(2 * i + r, 2 * i + k) = d[2 * r + k];
+          if(i > 0){
+            at(2 * i + r, 2 * (i - 1) + k) = l[2 * r + k];
+          }
+          if(i + 1 < diag.size()){
+            at(2 * i + r, 2 * (i + 1) + k) = u[2 * r + k];
+          }
+        }
+      }
+      b[2 * i] = rhs[i].x;
+      b[2 * i + 1] = rhs[i].y;
+    }
+    for(size_t k = 0; k < n; k++){
+      size_t last = min(n - 1, k + kl), end = min(n - 1, k + kl + ku);
+      size_t pivot = k;
+      for(size_t i = k + 1; i <= last; i++){
+        pivot = fabs(at(i, k)) > fabs(at(pivot, k)) ? i : pivot;
+      }
+      for(size_t j = k; j <= end; j++){
+        swap(at(k, j), at(pivot, j));
+      }
+      swap(b[k], b[pivot]);
+      for(size_t i = k + 1; i <= last; i++){
+        double factor = at(i, k) / at(k, k);
+        for(size_t j = k + 1; j <= end; j++){
+          at(i, j) -= factor * at(k, j);
+        }
+        b[i] -= factor * b[k];
+      }
+    }
+    for(size_t k = n; k-- > 0;){
+      double sum = b[k];
+      for(size_t j = k + 1; j <= min(n - 1, k + kl + ku); j++){
+        sum -= at(k, j) * b[j];
+      }
+      b[k] = sum / at(k, k);
+    }
+    vector<Vec2> x(diag.size());
+    for(size_t i = 0; i < diag.size(); i++){
+      x[i].x = b[2 * i];
+      x[i].y = b[2 * i + 1];
+    }
+    return x;
+  }
+
+  //-----------------------------------------------
+  /*
+  * This benchmark solves diagonally dominant block
+  * tridiagonal systems of n block rows with the block Thomas
+  * algorithm, with PCR on the ThreadPool, and as a generic
+  * banded system including its assembly, in ns per block row.
+  * The difference is the largest difference of a solution
+  * from the Thomas one.
+  */
+  //-----------------------------------------------
+  void benchTridiagonal(){
+    printf("tridiagonal: ns per block row, %zu cpus\n", ThreadPool::defaultThreadCount());
+    printf("%8s %10s %10s %10s %12s\n", "rows", "thomas", "pcr", "banded", "difference");
+    for(size_t n = 1 << 10; n <= (1 << 18); n <<= 4){
+      vector<Mat2x2> lower, diag, upper;
+      vector<Vec2> rhs;
+      for(size_t i = 0; i < n; i++){
+        double t = (double) i;
+        lower.push_back(Mat2x2(sin(t), 0.5 * cos(t), -0.3, 0.7 * sin(2 * t)));
+        upper.push_back(Mat2x2(0.4 * cos(t), -0.6, sin(3 * t), 0.2));
+        diag.push_back(Mat2x2(5 + sin(t), 1.3 * cos(t), -0.9, 6 - cos(t)));
+        Vec2 d = {cos(0.1 * t), sin(0.2 * t) - 1};
+        rhs.push_back(d);
+      }
+      vector<Vec2> thomas, pcr, banded;
+      double perRow = 1e9 / (double) n;
+      double thomasTime = bestOf([&]{ thomas = solveBlockTridiagonal(lower, diag, upper, rhs); });
+      double pcrTime = bestOf([&]{ pcr = solveBlockTridiagonalPcr(lower, diag, upper, rhs); });
+      double bandedTime = bestOf([&]{ banded = solveBanded(lower, diag, upper, rhs); });
+      double difference = 0;
+      for(size_t i = 0; i < n; i++){
+        difference = max(difference, max(fabs(pcr[i].x - thomas[i].x), fabs(pcr[i].y - thomas[i].y)));
+        difference = max(difference, max(fabs(banded[i].x - thomas[i].x), fabs(banded[i].y - thomas[i].y)));
+      }
+      printf("%8zu %10.1f %10.1f %10.1f %12.1e\n", n, thomasTime * perRow, pcrTime * perRow, bandedTime * perRow, difference);
+    }
+  }
+
+  //-----------------------------------------------
+  /*
+  * This benchmark evaluates the n step transition matrices of
+  * 1M chains with MarkovChainBatch, whose cost grows with the
+  * number of bits of n, and with a loop of
+  * MarkovChain2::transition(), in ns per chain.
+  */
+  //-----------------------------------------------
+  void benchMarkovChain(){
+    const size_t chains = 1 << 20;
+    mt19937_64 engine(2026);
+    uniform_real_distribution<double> probability(0, 1);
+    vector<double> p(chains), q(chains);
+    for(size_t i = 0; i < chains; i++){
+      p[i] = probability(engine);
+      q[i] = probability(engine);
+    }
+    MarkovChainBatch batch(p, q);
+    Mat2x2Batch<double> out(chains);
+    printf("markov: %zu chains, ns per chain, %zu cpus\n", chains, ThreadPool::defaultThreadCount());
+    printf("%22s %8s %8s\n", "steps", "batch", "loop");
+    uint64_t steps[] = {25, 1000000, ((uint64_t) 1 << 62) + 1};
+    for(int k = 0; k < 3; k++){
+      double batched = bestOf([&]{ batch.transitions(steps[k], out.view()); });
+      double loop = bestOf([&]{
+        double sum = 0;
+        for(size_t i = 0; i < chains; i++){
+          sum += MarkovChain2(p[i], q[i]).transition(steps[k])[1];
+        }
+        sink = sum;
+      });
+      printf("%22llu %8.2f %8.2f\n", (unsigned long long) steps[k], batched * 1e9 / chains, loop * 1e9 / chains);
+    }
+    sink = out.view().b[chains / 2];
+  }
+
+  //-----------------------------------------------
+  /*
+  * This function measures toTiles and fromTiles of count
+  * interleaved matrices in both element orders against a
+  * memcpy of the same bytes, in ns per matrix.
+  */
+  //-----------------------------------------------
+  template <typename T, size_t W>
+  void benchTiles(const char *name, size_t count){
+    vector<T> interleaved(4 * count), copy(4 * count);
+    for(size_t i = 0; i < interleaved.size(); i++){
+      interleaved[i] = (T) (i % 1000) / 1000;
+    }
+    vector<Mat2x2Tile<T, W> > tiles((count + W - 1) / W);
+    double perMatrix = 1e9 / (double) count;
+    double copied = bestOf([&]{ memcpy(copy.data(), interleaved.data(), interleaved.size() * sizeof(T)); });
+    ElementOrder orders[] = {ElementOrder::RowMajor, ElementOrder::ColumnMajor};
+    const char *orderNames[] = {"row", "column"};
+    for(int o = 0; o < 2; o++){
+      double to = bestOf([&]{ toTiles(interleaved.data(), count, orders[o], tiles.data()); });
+      double from = bestOf([&]{ fromTiles(tiles.data(), count, orders[o], copy.data()); });
+      printf("%12s %8zu %7s %8.2f %8.2f %8.2f %7.2fx %7.2fx\n", name, count, orderNames[o], copied * perMatrix,
+             to * perMatrix, from * perMatrix, to / copied, from / copied);
+    }
+    sink = copy[count / 2];
+  }
+
+  void benchTiles(){
+    printf("tiles: ns per matrix of memcpy, toTiles and fromTiles, and the conversions against memcpy\n");
+    printf("%12s %8s %7s %8s %8s %8s %8s %8s\n", "tile", "matrices", "order", "memcpy", "to", "from", "to", "from");
+    benchTiles<double, 4>("double x 4", 1 << 12);
+    benchTiles<double, 4>("double x 4", 1 << 20);
+    benchTiles<float, 8>("float x 8", 1 << 12);
+    benchTiles<float, 8>("float x 8", 1 << 20);
+  }
+
+  //-----------------------------------------------
+  /*
+  * This function measures a push and a product() of the
+  * sliding window, for streams independent
+  * SlidingWindowProduct objects and for one
+  * SlidingWindowProductBatch, in ns per stream and step.
+  */
+  //-----------------------------------------------
+  void benchWindow(size_t streams, size_t window){
+    const size_t steps = 4096;
+    mt19937_64 engine(2026);
+    uniform_real_distribution<double> element(-1, 1);
+    vector<Mat2x2Batch<double> > inputs(steps, Mat2x2Batch<double>(streams));
+    for(size_t step = 0; step < steps; step++){
+      for(size_t i = 0; i < streams; i++){
+        // rotations scaled by 1, so long windows neither overflow nor underflow
+        double angle = element(engine);
+        inputs[step].set(i, Mat2x2(cos(angle), -sin(angle), sin(angle), cos(angle)));
+      }
+    }
+    vector<vector<Mat2x2> > scalarInputs(steps);
+    for(size_t step = 0; step < steps; step++){
+      scalarInputs[step] = inputs[step].toMatrices();
+    }
+    Mat2x2Batch<double> out(streams);
+    double perStep = 1e9 / (double) (steps * streams);
+
+    double scalar = bestOf([&]{
+      vector<SlidingWindowProduct> windows(streams, SlidingWindowProduct(window));
+      double sum = 0;
+      for(size_t step = 0; step < steps; step++){
+        for(size_t i = 0; i < streams; i++){
+          windows[i].push(scalarInputs[step][i]);
+          sum += windows[i].product()[0];
+        }
+      }
+      sink = sum;
+    });
+    SlidingWindowProductBatch batch(streams, window);
+    double batched = bestOf([&]{
+      batch.clear();
+      double sum = 0;
+      for(size_t step = 0; step < steps; step++){
+        batch.push(inputs[step].view());
+        batch.product(out.view());
+        sum += out.view().a[0];
+      }
+      sink = sum;
+    });
+    printf("%8zu %8zu %10.2f %10.2f %8.1fx\n", streams, window, scalar * perStep, batched * perStep, scalar / batched);
+  }
+
+  void benchWindow(){
+    printf("window: %d steps of push and product(), ns per stream and step\n", 4096);
+    printf("%8s %8s %10s %10s %9s\n", "streams", "window", "scalar", "batch", "speedup");
+    benchWindow(1, 1024);
+    benchWindow(256, 16);
+    benchWindow(256, 1024);
+    benchWindow(4096, 16);
+    benchWindow(4096, 256);
+  }
+
+  struct Benchmark{
+    const char *name;
+    void (*run)();
+  };
+
+  const Benchmark benchmarks[] = {
+    {"threadpool", benchThreadPool},
+    {"memo", benchMemoCache},
+    {"batch", static_cast<void (*)()>(benchBatch)},
+    {"tiles", static_cast<void (*)()>(benchTiles)},
+    {"tridiagonal", benchTridiagonal},
+    {"markov", benchMarkovChain},
+    {"window", static_cast<void (*)()>(benchWindow)},
+#if defined(__SIZEOF_FLOAT128__)
+    {"decomposition", benchDecomposition},
+#endif
+  };
+}
+
+int main(int argc, char *argv[]){
+  bool found = false;
+  for(size_t i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++){
+    if(argc < 2 || strcmp(argv[1], benchmarks[i].name) == 0){
+      benchmarks[i].run();
+      found = true;
+    }
+  }
+  if(!found){
+    fprintf(stderr, "unknown benchmark %s\n", argv[1]);
+    return 1;
+  }
+  return 0;
+}
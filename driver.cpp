@@ -1,10 +1,40 @@
+#include "BlockTridiagonal.h"
+#include "ChainProduct.h"
+#include "Decomposition.h"
 #include "Mat2x2.h"
+#include "Mat2x2Batch.h"
+#include "Mat2x2Tiles.h"
+#include "MarkovChain.h"
+#include "Mobius.h"
+#include "MemoCache.h"
+#include "Parallel.h"
+#include "Pipeline.h"
+#include "RingBuffer.h"
+#include "SharedBatch.h"
+#include "SlidingWindow.h"
+#include "StreamPipeline.h"
+#include "ThreadPool.h"
+#include "Trace.h"
+#include "Workload.h"
 #include <iostream>
 #include <iomanip>
 #include <string>
+#include <algorithm>
 #include <cassert>
 #include <vector>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <complex>
+#include <deque>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#ifdef __linux__
+#include <fstream>
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
 using namespace std;
 
 /*
@@ -52,6 +82,1130 @@ void printEigenvalues(vector<double> numbers, int number){
   }
 }
 
+//-----------------------------------------------
+/*
+* Tests ThreadPool and the parallel algorithms, every result
+* must match the sequential one, including the order of a
+* non-commutative product, and exceptions must reach the
+* caller.
+*/
+//-----------------------------------------------
+void checkThreadPool(){
+  ThreadPool pool(4);
+  assert(pool.size() == 4);
+  assert(ThreadPool::numaNodeCount() >= 1);
+
+  vector<Mat2x2> mats;
+  for(int i = 0; i < 1000; i++){
+    mats.push_back(Mat2x2(1, (i % 7) * 0.001, (i % 5) * 0.001, 1));
+  }
+  vector<Mat2x2> inverses;
+  parallelTransform(pool, mats, inverses, 16, [](const Mat2x2 &mat){ return mat.inverse(); });
+  for(size_t i = 0; i < mats.size(); i++){
+    assert(inverses[i] == mats[i].inverse());
+  }
+
+  Mat2x2 sequential(1, 0, 0, 1);
+  for(size_t i = 0; i < mats.size(); i++){
+    sequential = sequential * mats[i];
+  }
+  Mat2x2 product = parallelReduce(pool, mats, 10, Mat2x2(1, 0, 0, 1), [](const Mat2x2 &lhs, const Mat2x2 &rhs){ return lhs * rhs; });
+  assert(product == sequential);
+
+  // nested loops, the waiting workers run the inner chunks
+  vector<int> counts(64, 0);
+  parallelFor(pool, 0, 8, 1, [&](size_t i){
+    parallelFor(pool, 0, 8, 1, [&](size_t j){ counts[(i * 8) + j]++; });
+  });
+  assert(count(counts.begin(), counts.end(), 1) == 64);
+
+  bool thrown = false;
+  try{
+    parallelFor(pool, 0, 100, 1, [](size_t i){
+      if(i == 42){
+        throw overflow_error("Inverse undefined");
+      }
+    });
+  }
+  catch(overflow_error &){
+    thrown = true;
+  }
+  assert(thrown);
+  cout << "ThreadPool checks passed\n";
+}
+
+//-----------------------------------------------
+/*
+* Tests the ring buffers and PipelineStage, the SPSC buffer
+* must keep the order, the MPMC buffer must deliver every
+* item exactly once, and a stage must forward the error of
+* its function to join().
+*/
+//-----------------------------------------------
+void checkRingBuffers(){
+  SpscRingBuffer<int> spsc(16);
+  assert(spsc.capacity() == 16);
+  thread producer([&spsc]{
+    for(int i = 0; i < 10000; i++){
+      while(!spsc.tryPush(i)){
+        this_thread::yield();
+      }
+    }
+    spsc.close();
+  });
+  int expected = 0, item;
+  while(true){
+    bool closed = spsc.isClosed();
+    if(spsc.tryPop(item)){
+      assert(item == expected++);
+    }
+    else if(closed){
+      break;
+    }
+  }
+  producer.join();
+  assert(expected == 10000);
+
+  MpmcRingBuffer<int> mpmc(64);
+  vector<int> seen(4000, 0);
+  vector<thread> threads;
+  for(int t = 0; t < 2; t++){
+    threads.push_back(thread([&mpmc, t]{
+      for(int i = t; i < 4000; i += 2){
+        while(!mpmc.tryPush(i)){
+          this_thread::yield();
+        }
+      }
+    }));
+  }
+  mutex seenLock;
+  for(int t = 0; t < 2; t++){
+    threads.push_back(thread([&]{
+      int value;
+      while(true){
+        bool closed = mpmc.isClosed();
+        if(mpmc.tryPop(value)){
+          lock_guard<mutex> guard(seenLock);
+          seen[value]++;
+        }
+        else if(closed){
+          break;
+        }
+      }
+    }));
+  }
+  threads[0].join();
+  threads[1].join();
+  mpmc.close();
+  threads[2].join();
+  threads[3].join();
+  assert(count(seen.begin(), seen.end(), 1) == 4000);
+
+  SpscRingBuffer<Mat2x2> input(64), middle(64), output(64);
+  PipelineStage<SpscRingBuffer<Mat2x2>, SpscRingBuffer<Mat2x2> > inverse(input, middle, [](const Mat2x2 &mat){ return mat.inverse(); });
+  PipelineStage<SpscRingBuffer<Mat2x2>, SpscRingBuffer<Mat2x2> > transpose(middle, output, [](const Mat2x2 &mat){ return mat.transpose(); });
+  vector<Mat2x2> results;
+  for(int i = 0; i < 200; i++){
+    while(!input.tryPush(Mat2x2(4 + i, 2, 3, 4 + i))){
+      Mat2x2 mat;
+      if(output.tryPop(mat)){
+        results.push_back(mat);
+      }
+    }
+  }
+  input.close();
+  while(true){
+    bool closed = output.isClosed();
+    Mat2x2 mat;
+    if(output.tryPop(mat)){
+      results.push_back(mat);
+    }
+    else if(closed){
+      break;
+    }
+  }
+  inverse.join();
+  transpose.join();
+  assert(results.size() == 200);
+  for(int i = 0; i < 200; i++){
+    assert(results[i] == Mat2x2(4 + i, 2, 3, 4 + i).inverse().transpose());
+  }
+
+  SpscRingBuffer<Mat2x2> singular(8), sink(8);
+  PipelineStage<SpscRingBuffer<Mat2x2>, SpscRingBuffer<Mat2x2> > failing(singular, sink, [](const Mat2x2 &mat){ return mat.inverse(); });
+  bool pushed = singular.tryPush(Mat2x2(1, 2, 2, 4));
+  assert(pushed);
+  singular.close();
+  bool thrown = false;
+  try{
+    failing.join();
+  }
+  catch(overflow_error &){
+    thrown = true;
+  }
+  assert(thrown && sink.isClosed());
+  cout << "RingBuffer checks passed\n";
+}
+
+//-----------------------------------------------
+/*
+* Tests StreamPipeline, the output must be in input order,
+* and malformed or truncated input must throw instead of
+* silently ending the output early.
+*/
+//-----------------------------------------------
+void checkStreamPipeline(){
+  stringstream in, out, expected;
+  for(int i = 0; i < 3000; i++){
+    Mat2x2 mat(4 + (i % 3), 1, (i % 2) == 0 ? 1 : 2, 4);
+    in << mat[0] << " " << mat[1] << " " << mat[2] << " " << mat[3] << "\n";
+    if(mat.isSymmetric()){
+      expected << mat.inverse();
+    }
+  }
+  size_t written = (stream::read(in, 100) | stream::filter(&Mat2x2::isSymmetric)
+                    | stream::map([](const Mat2x2 &mat){ return mat.inverse(); }) | stream::write(out)).run();
+  assert(written == 1500);
+  assert(out.str() == expected.str());
+
+  const char *malformed[] = {"1 0 0 1\n2 0 x 2\n3 0 0 3\n", "1 0 0 1\n2 0 0\n"};
+  for(int i = 0; i < 2; i++){
+    stringstream bad(malformed[i]), partial, first;
+    first << Mat2x2(1, 0, 0, 1);
+    bool thrown = false;
+    try{
+      (stream::read(bad) | stream::write(partial)).run();
+    }
+    catch(invalid_argument &){
+      thrown = true;
+    }
+    assert(thrown);
+    assert(partial.str() == first.str());
+  }
+  cout << "StreamPipeline checks passed\n";
+}
+
+//-----------------------------------------------
+/*
+* Tests Mat2x2MemoCache, a repeated matrix must be computed
+* once, the size must stay within the capacity, keys must be
+* bit-exact and exceptions must not be cached.
+*/
+//-----------------------------------------------
+void checkMemoCache(){
+  Mat2x2MemoCache<double> cache(64, 4);
+  int computed = 0;
+  auto trace = [&computed](const Mat2x2 &mat){ computed++; return mat[0] + mat[3]; };
+  for(int i = 0; i < 10; i++){
+    double value = cache.getOrCompute(Mat2x2(1, 2, 3, 4), trace);
+    assert(value == 5);
+  }
+  assert(computed == 1);
+  double negativeZero = cache.getOrCompute(Mat2x2(-0.0, 0, 0, 0), trace);
+  assert(negativeZero == 0 && computed == 2);
+  double positiveZero = cache.getOrCompute(Mat2x2(0.0, 0, 0, 0), trace);
+  assert(positiveZero == 0 && computed == 3);
+  CacheStats stats = cache.stats();
+  assert(stats.hits == 9 && stats.misses == 3 && stats.size == 3);
+
+  for(int i = 0; i < 1000; i++){
+    double value = cache.getOrCompute(Mat2x2(i, 1, 1, i), trace);
+    assert(value == 2 * i);
+  }
+  stats = cache.stats();
+  assert(stats.size <= 64 && stats.evictions > 0 && stats.hitRate() < 0.01);
+
+  bool thrown = false;
+  try{
+    cache.getOrCompute(Mat2x2(1, 2, 2, 4), [](const Mat2x2 &mat){ return mat.inverse()[0]; });
+  }
+  catch(overflow_error &){
+    thrown = true;
+  }
+  double afterThrow = cache.getOrCompute(Mat2x2(1, 2, 2, 4), trace);
+  assert(thrown && afterThrow == 5);
+
+  cache.clear();
+  stats = cache.stats();
+  assert(stats.size == 0 && stats.hits == 0 && stats.misses == 0);
+
+  Mat2x2MemoCache<double> shared(256);
+  parallelFor(0, 10000, [&shared](size_t i){
+    double x = (double) (i % 100);
+    double value = shared.getOrCompute(Mat2x2(x, 1, 1, x), [](const Mat2x2 &mat){ return mat[0] * 2; });
+    assert(value == 2 * x);
+  });
+  assert(shared.stats().hits + shared.stats().misses == 10000);
+  cout << "MemoCache checks passed\n";
+}
+
+//-----------------------------------------------
+/*
+* Tests the Mat2x2Batch kernels, the results must match the
+* Mat2x2 operations, also when the output is an input or a
+* shifted slice of one, and batchInverse must accept what
+* tryInverse() accepts and count the rest.
+*/
+//-----------------------------------------------
+void checkBatch(){
+  vector<Mat2x2> lhs, rhs;
+  for(int i = 0; i < 300; i++){
+    lhs.push_back(Mat2x2(i % 7 - 3, i % 5, 2 - i % 3, i % 11 + 1));
+    rhs.push_back(Mat2x2(i % 4, 1 - i % 6, i % 9, 3 - i % 2));
+  }
+  Mat2x2Batch<double> l(lhs), r(rhs), out(lhs.size());
+  batchMultiply(l.view(), r.view(), out.view());
+  for(size_t i = 0; i < lhs.size(); i++){
+    assert(out.get(i) == lhs[i] * rhs[i]);
+  }
+  batchMultiply(l.view(), r.view(), l.view());
+  for(size_t i = 0; i < lhs.size(); i++){
+    assert(l.get(i) == lhs[i] * rhs[i]);
+  }
+
+  // out[i] = m[i + 1] transposed, overlapping the input
+  Mat2x2Batch<double> m(rhs);
+  batchTranspose(m.view().slice(1, rhs.size()), m.view().slice(0, rhs.size() - 1));
+  for(size_t i = 0; i + 1 < rhs.size(); i++){
+    assert(m.get(i) == rhs[i + 1].transpose());
+  }
+
+  size_t singular = batchInverse(r.view(), out.view());
+  size_t rejected = 0;
+  for(size_t i = 0; i < rhs.size(); i++){
+    Mat2x2 inverse;
+    if(rhs[i].tryInverse(inverse)){
+      assert(out.get(i) == inverse);
+    }
+    else{
+      rejected++;
+      assert(std::isnan(out.get(i)[0]) && std::isnan(out.get(i)[3]));
+    }
+  }
+  assert(singular == rejected && rejected > 0);
+
+  Mat2x2Batch<double> small(vector<Mat2x2>(1, Mat2x2(0.001, 0, 0, -0.002)));
+  size_t smallRejected = batchInverse(small.view(), small.view());
+  assert(smallRejected == 0 && small.get(0) == Mat2x2(1000, 0, 0, -500));
+
+  // determinants whose reciprocal overflows, 1e-320 in double and 1e-40 in float
+  Mat2x2 tiny(1e-160, 0, 0, 1e-160), unused;
+  vector<Mat2x2> overflowing = {tiny, Mat2x2(), Mat2x2(49, 0, 0, 1)};
+  Mat2x2Batch<double> dOverflow(overflowing), dOverflowOut(overflowing.size());
+  Mat2x2Batch<float> fOverflow(vector<Mat2x2>{Mat2x2(1e-20, 0, 0, 1e-20), Mat2x2(), Mat2x2(49, 0, 0, 1)}), fOverflowOut(3);
+  size_t doubleRejected = batchInverse(dOverflow.view(), dOverflowOut.view());
+  size_t floatRejected = batchInverse(fOverflow.view(), fOverflowOut.view());
+  assert(doubleRejected == 2 && floatRejected == 2 && !tiny.tryInverse(unused));
+  assert(std::isnan(dOverflowOut.get(0)[0]) && std::isnan(fOverflowOut.get(0)[0]) && dOverflowOut.get(2)[0] == 1.0 / 49);
+
+  Mat2x2Batch<double> dl(lhs);
+  Mat2x2Batch<float> fl(lhs), fout(lhs.size());
+  size_t mixedRejected = batchInverse(fl.view(), fout.view(), Accumulate::Double);
+  size_t exactRejected = batchInverse(dl.view(), out.view());
+  assert(mixedRejected == exactRejected);
+  cout << "Mat2x2Batch checks passed\n";
+}
+
+//-----------------------------------------------
+/*
+* Tests the tile conversions, the register transposes of 4
+* doubles and 8 floats and the generic loops must give the
+* same matrices in both element orders, with a partial last
+* tile which is zero past the end.
+*/
+//-----------------------------------------------
+template <typename T, size_t W>
+void checkTileOrders(const vector<Mat2x2> &mats){
+  Mat2x2Tiles<T, W> tiles(mats);
+  for(size_t i = 0; i < mats.size(); i++){
+    assert(tiles.get(i) == mats[i]);
+  }
+  assert(tiles.toMatrices() == mats);
+  const Mat2x2Tile<T, W> &last = tiles.data()[tiles.tileCount() - 1];
+  for(size_t j = mats.size() % W; j < W && mats.size() % W != 0; j++){
+    assert(last.a[j] == 0 && last.b[j] == 0 && last.c[j] == 0 && last.d[j] == 0);
+  }
+
+  vector<T> columnMajor, back(4 * mats.size());
+  for(size_t i = 0; i < mats.size(); i++){
+    T elements[4] = {(T) mats[i][0], (T) mats[i][2], (T) mats[i][1], (T) mats[i][3]};
+    columnMajor.insert(columnMajor.end(), elements, elements + 4);
+  }
+  vector<Mat2x2Tile<T, W> > columnTiles(tiles.tileCount());
+  toTiles(columnMajor.data(), mats.size(), ElementOrder::ColumnMajor, columnTiles.data());
+  for(size_t i = 0; i < mats.size(); i++){
+    assert(columnTiles[i / W].b[i % W] == (T) mats[i][1] && columnTiles[i / W].c[i % W] == (T) mats[i][2]);
+  }
+  fromTiles(columnTiles.data(), mats.size(), ElementOrder::ColumnMajor, back.data());
+  assert(back == columnMajor);
+}
+
+void checkTiles(){
+  vector<Mat2x2> mats;
+  for(int i = 0; i < 37; i++){
+    mats.push_back(Mat2x2(i, 100 + i, 200 + i, 300 + i));
+  }
+  checkTileOrders<double, 4>(mats);
+  checkTileOrders<float, 8>(mats);
+  checkTileOrders<double, 3>(mats);
+  checkTileOrders<float, 8>(vector<Mat2x2>(mats.begin(), mats.begin() + 16));
+  cout << "Mat2x2Tiles checks passed\n";
+}
+
+//-----------------------------------------------
+/*
+* This is a helper method which solves the same block
+* tridiagonal system as scalar rows of width 2n with banded
+* Gaussian elimination and partial pivoting, the reference
+* for the block solvers. Row r only has columns r-3 to r+3,
+* pivoting widens that to r+6.
+*/
+//-----------------------------------------------
+vector<Vec2> solveBanded(const vector<Mat2x2> &lower, const vector<Mat2x2> &diag,
+                         const vector<Mat2x2> &upper, const vector<Vec2> &rhs){
+  size_t n = 2 * diag.size();
+  vector<vector<double> > rows(n, vector<double>(n + 1, 0));
+  for(size_t i = 0; i < diag.size(); i++){
+    for(int r = 0; r < 2; r++){
+      vector<double> &row = rows[2 * i + r];
+      for(int k = 0; k < 2; k++){
+        row[2 * i + k] = diag[i][2 * r + k];
+        if(i > 0){
+          row[2 * (i - 1) + k] = lower[i][2 * r + k];
+        }
+        if(i + 1 < diag.size()){
+          row[2 * (i + 1) + k] = upper[i][2 * r + k];
+        }
+      }
+      row[n] = r == 0 ? rhs[i].x : rhs[i].y;
+    }
+  }
+  for(size_t k = 0; k < n; k++){
+    size_t last = min(n, k + 4), end = min(n, k + 7);
+    size_t pivot = k;
+    for(size_t r = k + 1; r < last; r++){
+      if(fabs(rows[r][k]) > fabs(rows[pivot][k])){
+        pivot = r;
+      }
+    }
+    swap(rows[k], rows[pivot]);
+    for(size_t r = k + 1; r < last; r++){
+      double factor = rows[r][k] / rows[k][k];
+      for(size_t col = k; col < end; col++){
+        rows[r][col] -= factor * rows[k][col];
+      }
+      rows[r][n] -= factor * rows[k][n];
+    }
+  }
+  vector<double> x(n);
+  for(size_t k = n; k-- > 0;){
+    double sum = rows[k][n];
+    for(size_t col = k + 1; col < min(n, k + 7); col++){
+      sum -= rows[k][col] * x[col];
+    }
+    x[k] = sum / rows[k][k];
+  }
+  vector<Vec2> result(diag.size());
+  for(size_t i = 0; i < diag.size(); i++){
+    result[i].x = x[2 * i];
+    result[i].y = x[2 * i + 1];
+  }
+  return result;
+}
+
+//-----------------------------------------------
+/*
+* Tests the block tridiagonal solvers, the residual of the
+* Thomas and PCR solutions must be at rounding level and both
+* must agree with banded elimination.
+*/
+//-----------------------------------------------
+void checkBlockTridiagonal(){
+  size_t n = 300;
+  vector<Mat2x2> lower, diag, upper;
+  vector<Vec2> rhs;
+  for(size_t i = 0; i < n; i++){
+    double t = (double) i;
+    lower.push_back(Mat2x2(sin(t), 0.5 * cos(t), -0.3, 0.7 * sin(2 * t)));
+    upper.push_back(Mat2x2(0.4 * cos(t), -0.6, sin(3 * t), 0.2));
+    diag.push_back(Mat2x2(5 + sin(t), 1.3 * cos(t), -0.9, 6 - cos(t)));
+    Vec2 d = {cos(0.1 * t), sin(0.2 * t) - 1};
+    rhs.push_back(d);
+  }
+  vector<Vec2> thomas = solveBlockTridiagonal(lower, diag, upper, rhs);
+  vector<Vec2> pcr = solveBlockTridiagonalPcr(lower, diag, upper, rhs);
+  vector<Vec2> banded = solveBanded(lower, diag, upper, rhs);
+  double residual = 0, difference = 0, scale = 0;
+  for(size_t i = 0; i < n; i++){
+    const vector<Vec2> *solutions[2] = {&thomas, &pcr};
+    for(int k = 0; k < 2; k++){
+      const vector<Vec2> &x = *solutions[k];
+      double rx = (diag[i][0] * x[i].x) + (diag[i][1] * x[i].y) - rhs[i].x;
+      double ry = (diag[i][2] * x[i].x) + (diag[i][3] * x[i].y) - rhs[i].y;
+      if(i > 0){
+        rx += (lower[i][0] * x[i - 1].x) + (lower[i][1] * x[i - 1].y);
+        ry += (lower[i][2] * x[i - 1].x) + (lower[i][3] * x[i - 1].y);
+      }
+      if(i + 1 < n){
+        rx += (upper[i][0] * x[i + 1].x) + (upper[i][1] * x[i + 1].y);
+        ry += (upper[i][2] * x[i + 1].x) + (upper[i][3] * x[i + 1].y);
+      }
+      residual = max(residual, max(fabs(rx), fabs(ry)));
+      difference = max(difference, max(fabs(x[i].x - banded[i].x), fabs(x[i].y - banded[i].y)));
+    }
+    scale = max(scale, max(fabs(banded[i].x), fabs(banded[i].y)));
+  }
+  assert(residual < 1e-14 && difference < 1e-14 * scale);
+
+  vector<Mat2x2> singularDiag(diag);
+  singularDiag[0] = Mat2x2(1, 2, 2, 4);
+  bool thrown = false;
+  try{
+    solveBlockTridiagonal(lower, singularDiag, upper, rhs);
+  }
+  catch(overflow_error &){
+    thrown = true;
+  }
+  assert(thrown);
+  thrown = false;
+  try{
+    solveBlockTridiagonalPcr(lower, diag, upper, vector<Vec2>(n - 1));
+  }
+  catch(invalid_argument &){
+    thrown = true;
+  }
+  assert(thrown);
+  cout << "BlockTridiagonal checks passed\n";
+}
+
+//-----------------------------------------------
+/*
+* Tests the two state Markov chains, the closed form n step
+* matrix must match repeated products, including the
+* periodic p = q = 1 and the identity p = q = 0 chains,
+* keep its precision for tiny p and q, and the batch must
+* give the same results as one chain at a time.
+*/
+//-----------------------------------------------
+void checkMarkovChain(){
+  MarkovChain2 chain(Mat2x2(0.7, 0.3, 0.1, 0.9));
+  Mat2x2 power(1, 0, 0, 1);
+  for(int n = 1; n <= 50; n++){
+    power = power * chain.transition();
+    Mat2x2 closed = chain.transition(n);
+    for(int i = 0; i < 4; i++){
+      assert(fabs(closed[i] - power[i]) < 1e-14);
+    }
+  }
+  vector<double> stationary = chain.stationary();
+  assert(fabs(stationary[0] - 0.25) < 1e-15 && fabs(stationary[1] - 0.75) < 1e-15);
+  assert(fabs(chain.secondEigenvalue() - 0.6) < 1e-15);
+
+  MarkovChain2 periodic(1, 1), identity(0, 0);
+  assert(periodic.transition(7) == Mat2x2(0, 1, 1, 0) && periodic.transition(8) == Mat2x2(1, 0, 0, 1));
+  assert(identity.transition(1000) == Mat2x2(1, 0, 0, 1));
+  bool thrown = false;
+  try{
+    identity.stationary();
+  }
+  catch(overflow_error &){
+    thrown = true;
+  }
+  assert(thrown);
+
+  // (1 - 2e-12)^1e6 loses every digit of 1 - l^n in plain double, -expm1(1e6 * log1p(-2e-12)) doesn't
+  Mat2x2 slow = MarkovChain2(1e-12, 1e-12).transition(1000000);
+  double expected = 0.5 * -expm1(-2e-6 - 2e-18);
+  assert(fabs(slow[1] - expected) < 1e-15 * expected);
+
+  // l close to -1, its powers alternate and 1 - l^n must keep its precision too
+  double nearOne = 1 - 1e-12, gap = 2 - (nearOne + nearOne);
+  Mat2x2 alternating = MarkovChain2(nearOne, nearOne).transition(1000000);
+  double expectedAlternating = 0.5 * -expm1(1000000 * log1p(-gap));
+  assert(fabs(alternating[1] - expectedAlternating) < 1e-15 * expectedAlternating);
+
+  // the parity of steps past 2^53, which a double can't hold
+  uint64_t odd = ((uint64_t) 1 << 60) + 1;
+  assert(periodic.transition(odd) == Mat2x2(0, 1, 1, 0) && periodic.transition(odd - 1) == Mat2x2(1, 0, 0, 1));
+  assert(periodic.transition(UINT64_MAX) == Mat2x2(0, 1, 1, 0));
+
+  thrown = false;
+  try{
+    MarkovChain2 invalid(Mat2x2(0.5, 0.6, 0.1, 0.9));
+  }
+  catch(invalid_argument &){
+    thrown = true;
+  }
+  assert(thrown);
+
+  vector<double> p, q;
+  for(int i = 0; i < 10000; i++){
+    p.push_back((i % 101) / 100.0);
+    q.push_back((i % 37) / 36.0);
+  }
+  MarkovChainBatch batch(p, q);
+  Mat2x2Batch<double> out(batch.size());
+  batch.transitions(odd, out.view());
+  for(size_t i = 0; i < batch.size(); i++){
+    Mat2x2 expectedPower = MarkovChain2(p[i], q[i]).transition(odd);
+    for(int k = 0; k < 4; k++){
+      assert(fabs(out.get(i)[k] - expectedPower[k]) < 1e-15);
+    }
+  }
+  batch.transitions(25, out.view());
+  vector<double> state0(batch.size()), state1(batch.size());
+  batch.stationary(state0.data(), state1.data());
+  for(size_t i = 0; i < batch.size(); i++){
+    MarkovChain2 one(p[i], q[i]);
+    Mat2x2 expectedPower = one.transition(25);
+    for(int k = 0; k < 4; k++){
+      assert(fabs(out.get(i)[k] - expectedPower[k]) < 1e-15);
+    }
+    if(p[i] + q[i] == 0){
+      assert(std::isnan(state0[i]) && std::isnan(state1[i]));
+    }
+    else{
+      assert(fabs(state0[i] - one.stationary()[0]) < 1e-15 && fabs(state1[i] - one.stationary()[1]) < 1e-15);
+    }
+  }
+  cout << "MarkovChain checks passed\n";
+}
+
+//-----------------------------------------------
+/*
+* Tests the Mobius transformations, the array version must
+* match the point version, also in place and for the pole,
+* infinity and the 0/0 point of a singular matrix, and a
+* composed chain must match applying the chain one by one.
+*/
+//-----------------------------------------------
+void checkMobius(){
+  Mat2x2 mat(2, -1, 0.5, 3);
+  complex<double> inf(INFINITY, INFINITY);
+  assert(isComplexInfinity(applyMobius(mat, complex<double>(-6, 0))));
+  assert(applyMobius(mat, inf) == complex<double>(4, 0));
+  assert(isComplexInfinity(applyMobius(Mat2x2(2, 1, 0, 1), inf)));
+  complex<double> undefined = applyMobius(Mat2x2(1, 2, 2, 4), complex<double>(-2, 0));
+  assert(std::isnan(undefined.real()) && std::isnan(undefined.imag()));
+
+  vector<complex<double> > points;
+  for(int i = 0; i < 20000; i++){
+    points.push_back(complex<double>(sin(0.01 * i) * (i % 50), cos(0.03 * i)));
+  }
+  points[100] = complex<double>(-6, 0);
+  points[15000] = inf;
+  vector<complex<double> > mapped = applyMobius(mat, points);
+  for(size_t i = 0; i < points.size(); i++){
+    complex<double> expected = applyMobius(mat, points[i]);
+    if(isComplexInfinity(expected)){
+      assert(isComplexInfinity(mapped[i]));
+    }
+    else{
+      assert(abs(mapped[i] - expected) <= 1e-15 * max(1.0, abs(expected)));
+    }
+  }
+  vector<complex<double> > inPlace(points);
+  applyMobius(mat, inPlace.data(), inPlace.data(), inPlace.size());
+  for(size_t i = 0; i < points.size(); i++){
+    assert(isComplexInfinity(inPlace[i]) ? isComplexInfinity(mapped[i]) : inPlace[i] == mapped[i]);
+  }
+
+  vector<Mat2x2> chain;
+  chain.push_back(Mat2x2(1, 1, 0, 1));
+  chain.push_back(Mat2x2(0, -1, 1, 0));
+  chain.push_back(Mat2x2(2, 0, 0, 1));
+  assert(composeMobius(chain) == Mat2x2(0, -2, 1, 1));
+  vector<complex<double> > composed = applyMobius(chain, points);
+  for(size_t i = 0; i < 1000; i++){
+    complex<double> z = points[i];
+    for(size_t k = 0; k < chain.size(); k++){
+      z = applyMobius(chain[k], z);
+    }
+    assert(abs(composed[i] - z) <= 1e-14 * max(1.0, abs(z)));
+  }
+  cout << "Mobius checks passed\n";
+}
+
+//-----------------------------------------------
+/*
+* This is a helper method which checks svd() and polar() of
+* one matrix, against singular values in long double and
+* through the orthogonality of U, V and Q, the reconstruction
+* of the matrix and a positive semi-definite S. Returns the
+* decompositions for the exact checks of the caller.
+*/
+//-----------------------------------------------
+void checkDecompositionOf(const Mat2x2 &mat, Mat2x2Svd &usv, Mat2x2Polar &qs){
+  usv = svd(mat);
+  qs = polar(mat);
+  long double a = mat[0], b = mat[1], c = mat[2], d = mat[3];
+  long double s1 = (sqrtl(((a + d) * (a + d)) + ((c - b) * (c - b))) + sqrtl(((a - d) * (a - d)) + ((c + b) * (c + b)))) / 2;
+  long double s2 = s1 == 0 ? 0 : fabsl((a * d) - (b * c)) / s1;
+  double tolerance = 2e-15 * max((double) s1, 1e-300);
+  assert(fabsl(usv.sigma1 - s1) <= tolerance && fabsl(usv.sigma2 - s2) <= tolerance);
+  assert(usv.sigma1 >= usv.sigma2 && usv.sigma2 >= 0);
+
+  const Mat2x2 *orthogonal[3] = {&usv.u, &usv.v, &qs.orthogonal};
+  for(int k = 0; k < 3; k++){
+    Mat2x2 identity = orthogonal[k]->transpose() * *orthogonal[k];
+    assert(fabs(identity[0] - 1) < 2e-15 && fabs(identity[1]) < 2e-15 && fabs(identity[3] - 1) < 2e-15);
+  }
+  assert(usv.v.preciseDeterminant() > 0);
+  double sign = mat.preciseDeterminant() < 0 ? -1 : 1;
+  assert(usv.u.preciseDeterminant() * sign > 0 && qs.orthogonal.preciseDeterminant() * sign > 0);
+
+  Mat2x2 usvt = usv.u * Mat2x2(usv.sigma1, 0, 0, usv.sigma2) * usv.v.transpose();
+  Mat2x2 product = qs.orthogonal * qs.stretch;
+  for(int i = 0; i < 4; i++){
+    assert(fabs(usvt[i] - mat[i]) <= tolerance && fabs(product[i] - mat[i]) <= tolerance);
+  }
+  const Mat2x2 &stretch = qs.stretch;
+  assert(stretch[1] == stretch[2]);
+  assert(stretch[0] >= -tolerance && stretch[3] >= -tolerance);
+  assert(stretch.preciseDeterminant() >= -tolerance * (double) s1);
+}
+
+//-----------------------------------------------
+/*
+* Tests the singular value and polar decompositions on
+* random matrices, negative determinants, repeated singular
+* values and rank one matrices, and the batch versions
+* against the single matrix ones.
+*/
+//-----------------------------------------------
+void checkDecomposition(){
+  Mat2x2Svd usv;
+  Mat2x2Polar qs;
+  vector<Mat2x2> mats;
+  for(int i = 0; i < 500; i++){
+    double t = (double) i;
+    mats.push_back(Mat2x2(sin(t), cos(3 * t), sin(7 * t), cos(11 * t)));
+    mats.push_back(Mat2x2(sin(t), cos(3 * t), 2 * sin(t), 2 * cos(3 * t))); // rank one
+    mats.push_back(Mat2x2(cos(t), -sin(t), sin(t), cos(t)) * (1 + 1e-12 * i)); // repeated
+    mats.push_back(Mat2x2(cos(t), sin(t), sin(t), -cos(t)) * (1 + 1e-12 * i)); // reflection, repeated
+  }
+  for(size_t i = 0; i < mats.size(); i++){
+    checkDecompositionOf(mats[i], usv, qs);
+  }
+
+  checkDecompositionOf(Mat2x2(3, 0, 0, -2), usv, qs);
+  assert(usv.sigma1 == 3 && usv.sigma2 == 2);
+  assert(qs.orthogonal == Mat2x2(1, 0, 0, -1) && qs.stretch == Mat2x2(3, 0, 0, 2));
+  checkDecompositionOf(Mat2x2(0, 3, 3, 0), usv, qs);
+  assert(usv.sigma1 == 3 && usv.sigma2 == 3);
+  assert(qs.orthogonal == Mat2x2(0, 1, 1, 0) && qs.stretch == Mat2x2(3, 0, 0, 3));
+  checkDecompositionOf(Mat2x2(-1, 0, 0, -1), usv, qs);
+  assert(qs.orthogonal == Mat2x2(-1, 0, 0, -1) && qs.stretch == Mat2x2(1, 0, 0, 1));
+  checkDecompositionOf(Mat2x2(1, 2, 2, 4), usv, qs);
+  assert(fabs(usv.sigma1 - 5) < 1e-15 && usv.sigma2 == 0);
+  checkDecompositionOf(Mat2x2(), usv, qs);
+  assert(usv.sigma1 == 0 && qs.orthogonal == Mat2x2(1, 0, 0, 1) && qs.stretch == Mat2x2());
+
+  Mat2x2Batch<double> in(mats), u(mats.size()), v(mats.size()), q(mats.size()), stretch(mats.size());
+  vector<double> sigma1(mats.size()), sigma2(mats.size());
+  batchSvd(in.view(), u.view(), sigma1.data(), sigma2.data(), v.view());
+  batchPolar(in.view(), q.view(), stretch.view());
+  for(size_t i = 0; i < mats.size(); i++){
+    usv = svd(mats[i]);
+    qs = polar(mats[i]);
+    for(int k = 0; k < 4; k++){
+      assert(u.get(i)[k] == usv.u[k] && v.get(i)[k] == usv.v[k]);
+      assert(q.get(i)[k] == qs.orthogonal[k] && stretch.get(i)[k] == qs.stretch[k]);
+    }
+    assert(sigma1[i] == usv.sigma1 && sigma2[i] == usv.sigma2);
+  }
+  cout << "Decomposition checks passed\n";
+}
+
+//-----------------------------------------------
+/*
+* Tests isSimilar and the compensated determinant and
+* eigenvalues, a matrix must stay similar to T * M * T^-1
+* after rounding, and the eigenvalues must keep their
+* relative precision where the textbook formula cancels.
+*/
+//-----------------------------------------------
+void checkSimilarAndEigenvalues(){
+  Mat2x2 a(0.1, 0.2, 0.3, 0.4);
+  Mat2x2 t(1, 2, 3, 7), conjugated = t * a * t.inverse();
+  assert(a.isSimilar(conjugated) && conjugated.isSimilar(a));
+  assert(!a.isSimilar(Mat2x2(0.1, 0.2, 0.3, 0.41)) && !a.isSimilar(Mat2x2(0.1, 0.2, 0.35, 0.4)));
+  Mat2x2 large(1e6, 2e6, 3e6, 4e6), shuffled(4e6, 3e6, 2e6, 1e6);
+  assert(large.isSimilar(shuffled) && large.isSimilar(t * large * t.inverse()));
+  assert(!large.isSimilar(Mat2x2(1e6, 2e6, 3e6, 4.1e6)));
+
+  assert(Mat2x2(1e8 + 1, 1e8, 1e8, 1e8 - 1).preciseDeterminant() == -1);
+  assert(Mat2x2(1, 1e-9, -1e-9, 1).discriminant() < 0);
+
+  // triangular, so the eigenvalues are the diagonal, 3e-8 would cancel in trace/2 - sqrt(...)
+  Mat2x2 upper(1e8, 1, 0, 3e-8), lower(-1e8, 0, 1, -3e-8);
+  assert(fabs(upper(1)[0] - 1e8) <= 1e-16 * 1e8 && fabs(upper(2)[0] - 3e-8) <= 1e-15 * 3e-8);
+  assert(fabs(lower(1)[0] + 3e-8) <= 1e-15 * 3e-8 && fabs(lower(2)[0] + 1e8) <= 1e-16 * 1e8);
+  Mat2x2 rotation(2, -1, 1, 2);
+  assert(rotation(1)[0] == 2 && rotation(1)[1] == 1 && rotation(2)[0] == 2 && rotation(2)[1] == -1);
+  vector<double> repeated = Mat2x2(3, 0, 0, 3)(1);
+  assert(repeated.size() == 1 && repeated[0] == 3 && Mat2x2(3, 0, 0, 3)(2)[0] == 3);
+  cout << "isSimilar and eigenvalue checks passed\n";
+}
+
+//-----------------------------------------------
+/*
+* Tests that records of the subscript and stream operators
+* survive the trace file and replay, a subscript out of range
+* must be counted as an exception. Built with -DMAT2X2_TRACE
+* the operators themselves must be recorded too.
+*/
+//-----------------------------------------------
+void checkTrace(){
+  const string path = "driver-check.m2x2trace";
+  const Mat2x2 mat(1.5, -2, 0.1, 1.0 / 3);
+  TraceOp ops[] = {TraceOp::Subscript, TraceOp::ConstSubscript, TraceOp::Output, TraceOp::Input};
+  int arguments[] = {1, 4, 0, 0};
+  TraceRecorder &recorder = TraceRecorder::instance();
+  recorder.start(path);
+  for(int i = 0; i < 4; i++){
+    TraceRecord record = TraceRecord();
+    record.op = ops[i];
+    record.lhs = mat;
+    record.argument = arguments[i];
+    recorder.record(record);
+  }
+  size_t expected = 4;
+#ifdef MAT2X2_TRACE
+  Mat2x2 copy = mat, read;
+  double element = copy[1];
+  element += mat[2];
+  ostringstream out;
+  out << mat;
+  istringstream in("1 2 3 0.25");
+  streambuf *console = cout.rdbuf(out.rdbuf());
+  in >> read;
+  cout.rdbuf(console);
+  expected = 8;
+#endif
+  recorder.stop();
+
+  vector<TraceRecord> records = readTrace(path);
+  remove(path.c_str());
+  assert(records.size() == expected);
+  for(size_t i = 0; i < records.size(); i++){
+    double elements[4], expectedElements[4];
+    records[i].lhs.getElements(elements);
+    mat.getElements(expectedElements);
+    if(i == 7){
+      Mat2x2(1, 2, 3, 0.25).getElements(expectedElements);
+    }
+    assert(records[i].op == ops[i % 4] && equal(elements, elements + 4, expectedElements));
+    assert(traceOperandOf(records[i].op) != TraceOperand::Integer || records[i].argument == (i < 4 ? arguments[i] : (int) i - 3));
+  }
+
+  vector<TraceOpStats> stats = replayTrace(records, 3), grouped = replayTrace(records, 3, TraceReplay::GroupByOperator);
+  for(size_t op = 0; op < stats.size(); op++){
+    bool replayed = (TraceOp) op == TraceOp::Subscript || (TraceOp) op == TraceOp::ConstSubscript ||
+                    (TraceOp) op == TraceOp::Output || (TraceOp) op == TraceOp::Input;
+    assert(stats[op].count == (replayed ? 3 * expected / 4 : 0) && grouped[op].count == stats[op].count);
+    assert(grouped[op].exceptions == stats[op].exceptions && grouped[op].recordedNanoseconds == stats[op].recordedNanoseconds);
+    assert(stats[op].minNanoseconds <= stats[op].maxNanoseconds && grouped[op].minNanoseconds <= grouped[op].maxNanoseconds);
+  }
+  assert(stats[(size_t) TraceOp::Subscript].exceptions == 0 && stats[(size_t) TraceOp::ConstSubscript].exceptions == 3);
+  assert(stats[(size_t) TraceOp::Output].exceptions == 0 && stats[(size_t) TraceOp::Input].exceptions == 0);
+  assert(string(traceOpName(TraceOp::ConstSubscript)) == "operator[] const" && string(traceOpName(TraceOp::Input)) == ">>");
+#ifdef MAT2X2_TRACE
+  assert(element == -2 + 0.1);
+#endif
+  cout << "Trace checks passed\n";
+}
+
+//-----------------------------------------------
+/*
+* Tests the workload generator, a seed must give the same
+* matrices every time, every kind must have its property and
+* the elements must stay within the range, or 8 times it for
+* the scaled row of a Singular matrix.
+*/
+//-----------------------------------------------
+void checkWorkload(){
+  Mat2x2Generator first(42, 8), second(42, 8), other(43, 8);
+  vector<Mat2x2> mats = first.generate(1000), same = second.generate(1000), different = other.generate(1000);
+  size_t differing = 0;
+  for(size_t i = 0; i < mats.size(); i++){
+    double elements[4], sameElements[4], otherElements[4];
+    mats[i].getElements(elements);
+    same[i].getElements(sameElements);
+    different[i].getElements(otherElements);
+    assert(equal(elements, elements + 4, sameElements));
+    differing += !equal(elements, elements + 4, otherElements);
+    for(int k = 0; k < 4; k++){
+      assert(fabs(elements[k]) <= 8 * 8 * (1 + 1e-9)); // a Singular row may be 8 times the other
+    }
+  }
+  assert(differing == mats.size());
+
+  Mat2x2Generator generator(7, 100, 1e-6);
+  for(int i = 0; i < 1000; i++){
+    Mat2x2 singular = generator.next(MatrixKind::Singular), symmetric = generator.next(MatrixKind::Symmetric);
+    Mat2x2 nearSingular = generator.next(MatrixKind::NearSingular);
+    assert(singular.preciseDeterminant() == 0 && symmetric[1] == symmetric[2]);
+    assert(fabs(nearSingular.preciseDeterminant()) <= 8 * 100 * 100 * 1e-6 * 4);
+  }
+  vector<Mat2x2> symmetricOnly = generator.generate(100, WorkloadMix(0, 0, 1, 0));
+  for(size_t i = 0; i < symmetricOnly.size(); i++){
+    assert(symmetricOnly[i].isSymmetric());
+  }
+  bool threw = false;
+  try{
+    generator.next(WorkloadMix(0, 0, 0, 0));
+  }
+  catch(const invalid_argument &){
+    threw = true;
+  }
+  assert(threw);
+  cout << "Workload checks passed\n";
+}
+
+//-----------------------------------------------
+/*
+* This is a helper method which returns the largest error of
+* an element of product against the product of the matrices
+* of the deque, newest first, relative to its largest element.
+*/
+//-----------------------------------------------
+double windowError(const Mat2x2 &product, const deque<Mat2x2> &window){
+  Mat2x2 expected(1, 0, 0, 1);
+  for(size_t i = 0; i < window.size(); i++){
+    expected = window[i] * expected;
+  }
+  double largest = 0, error = 0;
+  for(int i = 0; i < 4; i++){
+    largest = max(largest, fabs(expected[i]));
+    error = max(error, fabs(product[i] - expected[i]));
+  }
+  return error / largest;
+}
+
+//-----------------------------------------------
+/*
+* Tests the sliding window products against a deque which
+* multiplies the whole window every step, with pops between
+* the pushes. Elements which are multiples of 1/8 keep every
+* product of 4 matrices exact, so both orders of
+* multiplication must agree exactly. Other matrices round, the
+* products may differ by 2e-16 per matrix of the window.
+*/
+//-----------------------------------------------
+void checkSlidingWindow(){
+  size_t windows[] = {1, 2, 3, 4, 7, 16, 64};
+  const size_t streams = 3;
+  for(size_t w = 0; w < sizeof(windows) / sizeof(windows[0]); w++){
+    size_t window = windows[w];
+    bool exact = window <= 4;
+    SlidingWindowProduct scalar(window);
+    SlidingWindowProductBatch batch(streams, window);
+    deque<Mat2x2> expected[streams];
+    Mat2x2Batch<double> in(streams), out(streams);
+    for(int i = 0; i < 1000; i++){
+      for(size_t s = 0; s < streams; s++){
+        double t = 0.37 * i + (double) s;
+        Mat2x2 mat = exact ? Mat2x2((i % 7) / 8.0 - 0.25, (i % 5 + s) / 8.0, 0.5 - (i % 3) / 8.0, (i % 11) / 8.0 - 0.5)
+                           : Mat2x2(cos(t) + 0.1 * sin(3.0 * i), -sin(t), sin(t) + 0.05 * cos(5.0 * i), cos(t));
+        in.set(s, mat);
+        expected[s].push_back(mat);
+        if(expected[s].size() > window){
+          expected[s].pop_front();
+        }
+      }
+      scalar.push(in.get(0));
+      batch.push(in.view());
+      if(i % 13 == 0 && expected[0].size() > 1){
+        scalar.pop();
+        batch.pop();
+        for(size_t s = 0; s < streams; s++){
+          expected[s].pop_front();
+        }
+      }
+      assert(scalar.size() == expected[0].size() && batch.size() == expected[0].size());
+      batch.product(out.view());
+      double bound = exact ? 0 : 2e-16 * (double) window;
+      assert(windowError(scalar.product(), expected[0]) <= bound);
+      for(size_t s = 0; s < streams; s++){
+        assert(windowError(out.get(s), expected[s]) <= bound);
+      }
+    }
+  }
+
+  SlidingWindowProduct empty(2);
+  bool threw = false;
+  try{
+    empty.pop();
+  }
+  catch(const out_of_range &){
+    threw = true;
+  }
+  assert(threw && empty.product() == Mat2x2(1, 0, 0, 1));
+  cout << "SlidingWindow checks passed\n";
+}
+
+//-----------------------------------------------
+/*
+* Tests the chain products on chains whose plain product
+* underflows or overflows, the batch must agree with the
+* scalar accumulator, and a subnormal element must still be
+* normalized into [0.5, 1).
+*/
+//-----------------------------------------------
+void checkChainProduct(){
+  const double ln2 = log(2.0);
+  Mat2x2 chains[] = {Mat2x2(1e-45, 0, 0, 1e-45), Mat2x2(2, 0, 0, 0.5), Mat2x2(1e45, 2e45, -3e45, 1e44), Mat2x2(0.9, 0.3, -0.2, 1.1)};
+  const size_t count = sizeof(chains) / sizeof(chains[0]);
+  ChainProductBatch batch(count);
+  Mat2x2Batch<double> mats(vector<Mat2x2>(chains, chains + count));
+  vector<ChainProduct> scalars(count);
+  for(int step = 0; step < 1000; step++){
+    batch.multiply(mats.view());
+    for(size_t i = 0; i < count; i++){
+      scalars[i].multiply(chains[i]);
+      if(step == 99 && i == 0){
+        double expected = (0.5 * log(2.0)) + (100 * log(1e-45));
+        assert(fabs(scalars[0].logNorm() - expected) <= 1e-13 * fabs(expected));
+      }
+    }
+  }
+  vector<double> logNorms(count), lyapunov(count);
+  vector<int64_t> exponents(count);
+  batch.logNorms(logNorms.data());
+  batch.lyapunovExponents(lyapunov.data());
+  batch.exponents(exponents.data());
+  for(size_t i = 0; i < count; i++){
+    assert(std::isfinite(scalars[i].logNorm()) && std::isfinite(logNorms[i]));
+    assert(fabs(logNorms[i] - scalars[i].logNorm()) <= 1e-13 * max(1.0, fabs(logNorms[i])));
+    assert(exponents[i] == scalars[i].exponent() && lyapunov[i] == logNorms[i] / 1000);
+  }
+  double underflow = ((0.5 * ln2) + (1000 * log(1e-45))) / 1000;
+  assert(fabs(scalars[0].lyapunovExponent() - underflow) <= 1e-13 * fabs(underflow));
+  assert(fabs(scalars[1].lyapunovExponent() - ln2) <= 1e-15);
+
+  ChainProduct subnormal;
+  subnormal.multiply(Mat2x2(1e-310, 0, 0, -3e-311));
+  subnormal.renormalize();
+  Mat2x2 normalized = subnormal.normalized();
+  assert(fabs(normalized[0]) >= 0.5 && fabs(normalized[0]) < 1 && subnormal.exponent() == -1029);
+  double expected = log(1e-310) + (0.5 * log(1.09));
+  assert(fabs(subnormal.logNorm() - expected) <= 1e-13 * fabs(expected));
+  assert(std::isnan(ChainProduct().lyapunovExponent()));
+  cout << "ChainProduct checks passed\n";
+}
+
+#ifdef __linux__
+//-----------------------------------------------
+/*
+* This is a helper method which waits up to two seconds for
+* a process to exit, a zombie which nobody reaps counts as
+* exited.
+*/
+//-----------------------------------------------
+bool waitForExit(pid_t pid){
+  for(int i = 0; i < 200; i++){
+    ifstream stat("/proc/" + to_string(pid) + "/stat");
+    string line;
+    if(!getline(stat, line) || line.substr(line.rfind(')') + 2, 1) == "Z"){
+      return true;
+    }
+    this_thread::sleep_for(chrono::milliseconds(10));
+  }
+  return false;
+}
+
+//-----------------------------------------------
+/*
+* Tests SharedMat2x2Region and ShardedBatchExecutor, a worker
+* which throws or dies must only fail that run, a dead worker
+* must be replaced only while the process is single-threaded,
+* and the workers must not outlive a parent which dies. It
+* runs before every other check, which start threads.
+*/
+//-----------------------------------------------
+void checkSharedBatch(){
+  SharedMat2x2Region region("/mat2x2-driver-" + to_string(getpid()), 1000, 3);
+  Mat2x2BatchView<double> lhs = region.view(0), rhs = region.view(1), out = region.view(2);
+  for(size_t i = 0; i < region.size(); i++){
+    lhs.a[i] = lhs.d[i] = (double) i;
+    rhs.b[i] = rhs.c[i] = 1;
+  }
+  unique_ptr<SharedMat2x2Region> attached = SharedMat2x2Region::attach(region.name());
+  assert(attached->size() == 1000 && attached->views() == 3 && attached->view(0).a[7] == 7);
+
+  auto job = [](SharedMat2x2Region &r, int operation, size_t first, size_t last){
+    if(operation == 1 && first == 0){
+      throw overflow_error("Inverse undefined");
+    }
+    if(operation == 2 && first == 0){
+      _exit(3);
+    }
+    if(operation == 3){
+      r.view(2).a[first] = (double) getpid();
+      return;
+    }
+    batchMultiply(r.view(0).slice(first, last), r.view(1).slice(first, last), r.view(2).slice(first, last));
+  };
+  ShardedBatchExecutor executor(region, 3, job);
+  assert(executor.workers() == 3);
+  executor.run(0);
+  for(size_t i = 0; i < region.size(); i++){
+    assert(out.a[i] == 0 && out.b[i] == (double) i && out.c[i] == (double) i && out.d[i] == 0);
+  }
+  int operations[] = {1, 2};
+  for(int k = 0; k < 2; k++){
+    bool thrown = false;
+    try{
+      executor.run(operations[k]);
+    }
+    catch(runtime_error &){
+      thrown = true;
+    }
+    assert(thrown);
+    executor.run(0);
+  }
+
+  // with a second thread a dead worker stays missing until the process is single-threaded again
+  mutex lock;
+  lock.lock();
+  thread other([&lock]{ lock_guard<mutex> guard(lock); });
+  for(int k = 0; k < 2; k++){
+    bool thrown = false;
+    try{
+      executor.run(k == 0 ? 2 : 0);
+    }
+    catch(runtime_error &){
+      thrown = true;
+    }
+    assert(thrown);
+  }
+  lock.unlock();
+  other.join();
+  for(int attempt = 0; ; attempt++){
+    try{
+      executor.run(0); // the joined thread may still be listed for a moment
+      break;
+    }
+    catch(runtime_error &){
+      assert(attempt < 100);
+      this_thread::sleep_for(chrono::milliseconds(10));
+    }
+  }
+
+  // a parent which dies without the destructor takes its workers with it
+  pid_t parent = fork();
+  if(parent == 0){
+    ShardedBatchExecutor orphans(region, 2, job);
+    orphans.run(3);
+    _exit(0);
+  }
+  waitpid(parent, NULL, 0);
+  assert(waitForExit((pid_t) out.a[0]) && waitForExit((pid_t) out.a[region.size() / 2]));
+  cout << "SharedBatch checks passed\n";
+}
+#endif
+
 int main()
 {
    Mat2x2 m1(2, -1, 1, 2); // test constructor
@@ -205,6 +1359,25 @@ int main()
    // revision 1: end
    //--------------------------------------------------
 
+#ifdef __linux__
+   checkSharedBatch();
+#endif
+   checkThreadPool();
+   checkRingBuffers();
+   checkStreamPipeline();
+   checkMemoCache();
+   checkBatch();
+   checkTiles();
+   checkBlockTridiagonal();
+   checkMarkovChain();
+   checkMobius();
+   checkDecomposition();
+   checkSimilarAndEigenvalues();
+   checkTrace();
+   checkWorkload();
+   checkSlidingWindow();
+   checkChainProduct();
+
    cout << "Test completed successfully!" << endl;
    return 0;
 }